@@ -0,0 +1,385 @@
+#define _GNU_SOURCE
+
+#include "Barriers.h"
+
+#include <stdlib.h>
+#include <limits.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+//----------------
+// Waiting on flags
+//----------------
+
+const unsigned BARRIER_CYCLES_TO_SPIN = 100;
+
+void barrier_thread_init(struct BarrierThread* thread, unsigned thread_id)
+{
+	thread->thread_id = thread_id;
+	thread->sense     = 0;
+	thread->parity    = 0;
+}
+
+// Spin, then yield or sleep until *word == value:
+static void barrier_flag_wait(volatile int* word, volatile unsigned* num_sleepers, int value, int futex_fallback)
+{
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		int current = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+		if (current == value) return;
+
+		if (cycle_no < BARRIER_CYCLES_TO_SPIN)
+		{
+			spinloop_pause();
+			continue;
+		}
+
+		if (!futex_fallback)
+		{
+			sched_yield();
+			continue;
+		}
+
+		// Either the releasing thread sees the sleeper, or the sleeper sees the new value:
+		__atomic_add_fetch(num_sleepers, 1, __ATOMIC_SEQ_CST);
+
+		if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == current)
+		{
+			// No value-checking: spurious wake-ups and EAGAIN are handled by the loop
+			syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, current, NULL, NULL, 0);
+		}
+
+		__atomic_sub_fetch(num_sleepers, 1, __ATOMIC_SEQ_CST);
+	}
+}
+
+static void barrier_flag_publish(volatile int* word, volatile unsigned* num_sleepers, int value, int futex_fallback)
+{
+	__atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+
+	if (futex_fallback && __atomic_load_n(num_sleepers, __ATOMIC_SEQ_CST) != 0)
+	{
+		syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+	}
+}
+
+//-------------------------------------
+// Centralized sense-reversing barrier
+//-------------------------------------
+
+int SenseBarrier_init(struct SenseBarrier* barrier, unsigned num_threads, int futex_fallback)
+{
+	if (num_threads == 0) return -1;
+
+	barrier->num_arrived    = 0;
+	barrier->num_threads    = num_threads;
+	barrier->futex_fallback = futex_fallback;
+
+	barrier->sense.value        = 0;
+	barrier->sense.num_sleepers = 0;
+
+	return 0;
+}
+
+void SenseBarrier_wait(struct SenseBarrier* barrier, struct BarrierThread* thread)
+{
+	thread->sense = !thread->sense;
+
+	if (__atomic_add_fetch(&barrier->num_arrived, 1, __ATOMIC_ACQ_REL) == barrier->num_threads)
+	{
+		barrier->num_arrived = 0;
+
+		barrier_flag_publish(&barrier->sense.value, &barrier->sense.num_sleepers, thread->sense, barrier->futex_fallback);
+		return;
+	}
+
+	barrier_flag_wait(&barrier->sense.value, &barrier->sense.num_sleepers, thread->sense, barrier->futex_fallback);
+}
+
+//------------------------
+// Combining-tree barrier
+//------------------------
+// P. Yew, N. Tzeng, D. Lawrie "Distributing Hot-Spot Addressing in Large-Scale Multiprocessors"
+
+static unsigned tree_level_size(unsigned num_children)
+{
+	return (num_children + TREE_BARRIER_FAN_IN - 1) / TREE_BARRIER_FAN_IN;
+}
+
+int TreeBarrier_init(struct TreeBarrier* barrier, unsigned num_threads, int futex_fallback)
+{
+	// The level loop below never reaches a single root for no threads:
+	if (num_threads == 0) return -1;
+
+	barrier->num_threads    = num_threads;
+	barrier->futex_fallback = futex_fallback;
+
+	barrier->sense.value        = 0;
+	barrier->sense.num_sleepers = 0;
+
+	// Levels shrink by TREE_BARRIER_FAN_IN down to a single root:
+	barrier->num_nodes = 0;
+
+	for (unsigned level_size = tree_level_size(num_threads); ; level_size = tree_level_size(level_size))
+	{
+		barrier->num_nodes += level_size;
+
+		if (level_size == 1) break;
+	}
+
+	barrier->nodes = aligned_alloc(L1D_LINESIZE, barrier->num_nodes * sizeof(struct TreeBarrierNode));
+	if (barrier->nodes == NULL) return -1;
+
+	// Link every level to the next one:
+	unsigned level_start  = 0;
+	unsigned num_children = num_threads;
+
+	for (unsigned level_size = tree_level_size(num_threads); ; level_size = tree_level_size(level_size))
+	{
+		unsigned next_level_start = level_start + level_size;
+
+		for (unsigned node_i = 0; node_i < level_size; ++node_i)
+		{
+			struct TreeBarrierNode* node = &barrier->nodes[level_start + node_i];
+
+			node->num_arrived  = 0;
+			node->num_children = (num_children - node_i * TREE_BARRIER_FAN_IN < TREE_BARRIER_FAN_IN)?
+			                     num_children - node_i * TREE_BARRIER_FAN_IN : TREE_BARRIER_FAN_IN;
+
+			node->parent = (level_size == 1)? NULL : &barrier->nodes[next_level_start + node_i / TREE_BARRIER_FAN_IN];
+		}
+
+		if (level_size == 1) break;
+
+		level_start  = next_level_start;
+		num_children = level_size;
+	}
+
+	return 0;
+}
+
+void TreeBarrier_wait(struct TreeBarrier* barrier, struct BarrierThread* thread)
+{
+	thread->sense = !thread->sense;
+
+	// Climb while being the last to arrive:
+	for (struct TreeBarrierNode* node = &barrier->nodes[thread->thread_id / TREE_BARRIER_FAN_IN]; node != NULL; node = node->parent)
+	{
+		if (__atomic_add_fetch(&node->num_arrived, 1, __ATOMIC_ACQ_REL) != node->num_children)
+		{
+			barrier_flag_wait(&barrier->sense.value, &barrier->sense.num_sleepers, thread->sense, barrier->futex_fallback);
+			return;
+		}
+
+		// Nobody arrives here again before the release below:
+		node->num_arrived = 0;
+	}
+
+	barrier_flag_publish(&barrier->sense.value, &barrier->sense.num_sleepers, thread->sense, barrier->futex_fallback);
+}
+
+void TreeBarrier_destroy(struct TreeBarrier* barrier)
+{
+	free(barrier->nodes);
+
+	barrier->nodes     = NULL;
+	barrier->num_nodes = 0;
+}
+
+//-----------------------
+// Dissemination barrier
+//-----------------------
+// D. Hensgen, R. Finkel, U. Manber "Two Algorithms for Barrier Synchronization"
+// J. Mellor-Crummey, M. Scott "Algorithms for Scalable Synchronization on Shared-Memory Multiprocessors"
+
+int DisseminationBarrier_init(struct DisseminationBarrier* barrier, unsigned num_threads, int futex_fallback)
+{
+	if (num_threads == 0) return -1;
+
+	barrier->num_threads    = num_threads;
+	barrier->futex_fallback = futex_fallback;
+
+	barrier->num_rounds = 0;
+	while ((1u << barrier->num_rounds) < num_threads) barrier->num_rounds += 1;
+
+	if (barrier->num_rounds > DISSEMINATION_MAX_ROUNDS) return -1;
+
+	barrier->nodes = aligned_alloc(L1D_LINESIZE, num_threads * sizeof(struct DisseminationNode));
+	if (barrier->nodes == NULL) return -1;
+
+	for (unsigned thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		for (unsigned round = 0; round < DISSEMINATION_MAX_ROUNDS; ++round)
+		{
+			barrier->nodes[thread_i].flags[0][round] = 0;
+			barrier->nodes[thread_i].flags[1][round] = 0;
+		}
+
+		barrier->nodes[thread_i].num_sleepers = 0;
+	}
+
+	return 0;
+}
+
+void DisseminationBarrier_wait(struct DisseminationBarrier* barrier, struct BarrierThread* thread)
+{
+	// Flags start at 0, so the first crossing of either parity signals 1:
+	const int value = !thread->sense;
+
+	struct DisseminationNode* own = &barrier->nodes[thread->thread_id];
+
+	for (unsigned round = 0; round < barrier->num_rounds; ++round)
+	{
+		struct DisseminationNode* partner = &barrier->nodes[(thread->thread_id + (1u << round)) % barrier->num_threads];
+
+		barrier_flag_publish(&partner->flags[thread->parity][round], &partner->num_sleepers, value, barrier->futex_fallback);
+
+		barrier_flag_wait(&own->flags[thread->parity][round], &own->num_sleepers, value, barrier->futex_fallback);
+	}
+
+	// Every other crossing reuses the flags of the same parity with the opposite value:
+	if (thread->parity == 1) thread->sense = !thread->sense;
+
+	thread->parity = 1 - thread->parity;
+}
+
+void DisseminationBarrier_destroy(struct DisseminationBarrier* barrier)
+{
+	free(barrier->nodes);
+
+	barrier->nodes = NULL;
+}
+
+//-------------------------
+// Barrier object interface
+//-------------------------
+
+int barrier_create(struct Barrier* barrier, const struct BarrierOps* ops, unsigned num_threads, int futex_fallback)
+{
+	// aligned_alloc() wants the size to be a multiple of the alignment:
+	size_t size = (ops->size + ops->alignment - 1) / ops->alignment * ops->alignment;
+
+	void* instance = aligned_alloc(ops->alignment, size);
+	if (instance == NULL) return -1;
+
+	if (ops->init(instance, num_threads, futex_fallback) != 0)
+	{
+		free(instance);
+		return -1;
+	}
+
+	barrier->ops      = ops;
+	barrier->instance = instance;
+
+	return 0;
+}
+
+void barrier_destroy(struct Barrier* barrier)
+{
+	if (barrier->ops->destroy != NULL) barrier->ops->destroy(barrier->instance);
+
+	free(barrier->instance);
+
+	barrier->instance = NULL;
+}
+
+static int SenseBarrier_ops_init(void* instance, unsigned num_threads, int futex_fallback)
+{
+	return SenseBarrier_init((struct SenseBarrier*) instance, num_threads, futex_fallback);
+}
+
+static void SenseBarrier_ops_wait(void* instance, struct BarrierThread* thread)
+{
+	SenseBarrier_wait((struct SenseBarrier*) instance, thread);
+}
+
+static int TreeBarrier_ops_init(void* instance, unsigned num_threads, int futex_fallback)
+{
+	return TreeBarrier_init((struct TreeBarrier*) instance, num_threads, futex_fallback);
+}
+
+static void TreeBarrier_ops_wait(void* instance, struct BarrierThread* thread)
+{
+	TreeBarrier_wait((struct TreeBarrier*) instance, thread);
+}
+
+static void TreeBarrier_ops_destroy(void* instance)
+{
+	TreeBarrier_destroy((struct TreeBarrier*) instance);
+}
+
+static int DisseminationBarrier_ops_init(void* instance, unsigned num_threads, int futex_fallback)
+{
+	return DisseminationBarrier_init((struct DisseminationBarrier*) instance, num_threads, futex_fallback);
+}
+
+static void DisseminationBarrier_ops_wait(void* instance, struct BarrierThread* thread)
+{
+	DisseminationBarrier_wait((struct DisseminationBarrier*) instance, thread);
+}
+
+static void DisseminationBarrier_ops_destroy(void* instance)
+{
+	DisseminationBarrier_destroy((struct DisseminationBarrier*) instance);
+}
+
+const struct BarrierOps SENSE_BARRIER_OPS =
+{
+	.name      = "Sense-reversing barrier",
+	.size      = sizeof (struct SenseBarrier),
+	.alignment = _Alignof(struct SenseBarrier),
+	.init      = SenseBarrier_ops_init,
+	.wait      = SenseBarrier_ops_wait
+};
+
+const struct BarrierOps TREE_BARRIER_OPS =
+{
+	.name      = "Combining-tree barrier",
+	.size      = sizeof (struct TreeBarrier),
+	.alignment = _Alignof(struct TreeBarrier),
+	.init      = TreeBarrier_ops_init,
+	.wait      = TreeBarrier_ops_wait,
+	.destroy   = TreeBarrier_ops_destroy
+};
+
+const struct BarrierOps DISSEMINATION_BARRIER_OPS =
+{
+	.name      = "Dissemination barrier",
+	.size      = sizeof (struct DisseminationBarrier),
+	.alignment = _Alignof(struct DisseminationBarrier),
+	.init      = DisseminationBarrier_ops_init,
+	.wait      = DisseminationBarrier_ops_wait,
+	.destroy   = DisseminationBarrier_ops_destroy
+};
+
+//---------------------------
+// Baseline: pthread barrier
+//---------------------------
+
+static int pthread_barrier_ops_init(void* instance, unsigned num_threads, int futex_fallback)
+{
+	return (pthread_barrier_init((pthread_barrier_t*) instance, NULL, num_threads) == 0)? 0 : -1;
+}
+
+static void pthread_barrier_ops_wait(void* instance, struct BarrierThread* thread)
+{
+	pthread_barrier_wait((pthread_barrier_t*) instance);
+}
+
+static void pthread_barrier_ops_destroy(void* instance)
+{
+	pthread_barrier_destroy((pthread_barrier_t*) instance);
+}
+
+const struct BarrierOps PTHREAD_BARRIER_OPS =
+{
+	.name      = "pthread_barrier",
+	.size      = sizeof (pthread_barrier_t),
+	.alignment = _Alignof(pthread_barrier_t),
+	.init      = pthread_barrier_ops_init,
+	.wait      = pthread_barrier_ops_wait,
+	.destroy   = pthread_barrier_ops_destroy
+};
@@ -0,0 +1,184 @@
+#ifndef BARRIERS_HPP_INCLUDED
+#define BARRIERS_HPP_INCLUDED
+
+#include "SpinLocks.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------
+// Barriers
+//------------------------------------------------------------------
+// Reusable barriers for iterative parallel phases:
+//     struct Barrier barrier;
+//     barrier_create(&barrier, &TREE_BARRIER_OPS, num_threads, 0);
+//     ...
+//     // Every thread, with its own struct BarrierThread:
+//     barrier_thread_init(&thread, thread_id);
+//     barrier_wait(&barrier, &thread);
+//     ...
+//     barrier_destroy(&barrier);
+// - Every thread keeps its own sense (and parity), so no barrier
+//   has to be reset between phases
+// - Words written by different threads live on separate cache lines
+// - Waiters spin, then yield the CPU, or with the futex fallback
+//   sleep until the releasing thread wakes them
+// - init returns 0 on success and -1 on failure, a barrier for
+//   no threads is refused
+//------------------------------------------------------------------
+
+// One per thread and barrier:
+struct BarrierThread
+{
+	// 0 .. num_threads-1, distinct for every thread:
+	unsigned thread_id;
+
+	int sense;
+	unsigned parity;
+};
+
+void barrier_thread_init(struct BarrierThread* thread, unsigned thread_id);
+
+// Word the waiters spin (or sleep) on:
+struct BarrierFlag
+{
+	volatile int value;
+
+	// Waiters in futex_wait(), the releasing thread wakes them only if any:
+	volatile unsigned num_sleepers;
+} CACHE_LINE_ALIGNED;
+
+//------------------------------------------------------------------
+// Centralized sense-reversing barrier
+//------------------------------------------------------------------
+// Optimizations:
+// - One fetch-and-add per arrival, the last thread to arrive
+//   resets the counter and flips the global sense
+// - The arrival counter and the sense are on separate cache lines,
+//   so arrivals don't invalidate the line the waiters spin on
+//------------------------------------------------------------------
+
+struct SenseBarrier
+{
+	volatile unsigned num_arrived;
+
+	unsigned num_threads;
+	int futex_fallback;
+
+	struct BarrierFlag sense;
+};
+
+int  SenseBarrier_init(struct SenseBarrier* barrier, unsigned num_threads, int futex_fallback);
+void SenseBarrier_wait(struct SenseBarrier* barrier, struct BarrierThread* thread);
+
+//------------------------------------------------------------------
+// Combining-tree barrier
+//------------------------------------------------------------------
+// Optimizations:
+// - Threads arrive at leaves of TREE_BARRIER_FAN_IN threads each,
+//   the last arrival at a node arrives at its parent, so no counter
+//   is written by more than TREE_BARRIER_FAN_IN threads
+// - Every node is cache-line-padded
+// - The last arrival at the root flips the global sense
+//------------------------------------------------------------------
+
+#define TREE_BARRIER_FAN_IN 4
+
+struct TreeBarrierNode
+{
+	volatile unsigned num_arrived;
+	unsigned num_children;
+
+	struct TreeBarrierNode* parent;
+} CACHE_LINE_ALIGNED;
+
+struct TreeBarrier
+{
+	unsigned num_threads;
+	int futex_fallback;
+
+	// Leaves first, the root last:
+	unsigned num_nodes;
+	struct TreeBarrierNode* nodes;
+
+	struct BarrierFlag sense;
+};
+
+int  TreeBarrier_init   (struct TreeBarrier* barrier, unsigned num_threads, int futex_fallback);
+void TreeBarrier_wait   (struct TreeBarrier* barrier, struct BarrierThread* thread);
+void TreeBarrier_destroy(struct TreeBarrier* barrier);
+
+//------------------------------------------------------------------
+// Dissemination barrier
+//------------------------------------------------------------------
+// Optimizations:
+// - No counters and no atomic read-modify-write: in round r thread i
+//   signals thread (i + 2^r) mod P and waits for its own flag,
+//   so a crossing takes ceil(log2 P) rounds
+// - Every thread spins on flags in its own cache-line-padded node
+// - Flags alternate between two parities, so they are never reset
+//------------------------------------------------------------------
+
+#define DISSEMINATION_MAX_ROUNDS 16
+
+struct DisseminationNode
+{
+	volatile int flags[2][DISSEMINATION_MAX_ROUNDS];
+
+	volatile unsigned num_sleepers;
+} CACHE_LINE_ALIGNED;
+
+struct DisseminationBarrier
+{
+	unsigned num_threads;
+	unsigned num_rounds;
+	int futex_fallback;
+
+	struct DisseminationNode* nodes;
+};
+
+int  DisseminationBarrier_init   (struct DisseminationBarrier* barrier, unsigned num_threads, int futex_fallback);
+void DisseminationBarrier_wait   (struct DisseminationBarrier* barrier, struct BarrierThread* thread);
+void DisseminationBarrier_destroy(struct DisseminationBarrier* barrier);
+
+//------------------------------------------------------------------
+// Barrier object interface
+//------------------------------------------------------------------
+// As struct Lock of LockInterface.h: a table of operations over an
+// opaque instance. pthread_barrier_t is the baseline, it ignores
+// futex_fallback (it always sleeps).
+//------------------------------------------------------------------
+
+struct BarrierOps
+{
+	const char* name;
+
+	// Memory layout of one instance:
+	size_t size;
+	size_t alignment;
+
+	int  (*init)   (void* instance, unsigned num_threads, int futex_fallback);
+	void (*wait)   (void* instance, struct BarrierThread* thread);
+	void (*destroy)(void* instance);
+};
+
+struct Barrier
+{
+	const struct BarrierOps* ops;
+	void* instance;
+};
+
+// Allocate and init an instance, return 0 on success and -1 on failure:
+int  barrier_create (struct Barrier* barrier, const struct BarrierOps* ops, unsigned num_threads, int futex_fallback);
+void barrier_destroy(struct Barrier* barrier);
+
+static inline void barrier_wait(struct Barrier* barrier, struct BarrierThread* thread)
+{
+	barrier->ops->wait(barrier->instance, thread);
+}
+
+extern const struct BarrierOps SENSE_BARRIER_OPS;
+extern const struct BarrierOps TREE_BARRIER_OPS;
+extern const struct BarrierOps DISSEMINATION_BARRIER_OPS;
+extern const struct BarrierOps PTHREAD_BARRIER_OPS;
+
+#endif // BARRIERS_HPP_INCLUDED
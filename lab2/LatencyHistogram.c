@@ -0,0 +1,85 @@
+#include "LatencyHistogram.h"
+
+#include <string.h>
+
+//----------------
+// Bucket indexing
+//----------------
+
+// Values below 2*HISTOGRAM_SUB_BUCKETS map one-to-one, larger values keep
+// their HISTOGRAM_SUB_BUCKET_BITS most significant bits after the leading one:
+static unsigned bucket_of(uint64_t value)
+{
+	if (value < HISTOGRAM_SUB_BUCKETS) return value;
+
+	unsigned shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BUCKET_BITS;
+
+	return (shift + 1) * HISTOGRAM_SUB_BUCKETS + (value >> shift) - HISTOGRAM_SUB_BUCKETS;
+}
+
+static uint64_t bucket_upper_bound(unsigned bucket)
+{
+	if (bucket < HISTOGRAM_SUB_BUCKETS) return bucket;
+
+	unsigned shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+	uint64_t lower = (uint64_t) (bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS) << shift;
+
+	return lower + ((1ull << shift) - 1);
+}
+
+//------------
+// Histogram
+//------------
+
+void histogram_reset(struct LatencyHistogram* histogram)
+{
+	memset(histogram, 0, sizeof(*histogram));
+}
+
+void histogram_record(struct LatencyHistogram* histogram, uint64_t value)
+{
+	histogram->counts[bucket_of(value)] += 1;
+
+	histogram->num_values += 1;
+	histogram->sum        += value;
+
+	if (histogram->max < value) histogram->max = value;
+}
+
+void histogram_merge(struct LatencyHistogram* to, const struct LatencyHistogram* from)
+{
+	for (unsigned bucket = 0; bucket < HISTOGRAM_NUM_BUCKETS; ++bucket)
+	{
+		to->counts[bucket] += from->counts[bucket];
+	}
+
+	to->num_values += from->num_values;
+	to->sum        += from->sum;
+
+	if (to->max < from->max) to->max = from->max;
+}
+
+uint64_t histogram_percentile(const struct LatencyHistogram* histogram, double percentile)
+{
+	if (histogram->num_values == 0) return 0;
+
+	// Rank of the value, rounded up:
+	uint64_t rank = (uint64_t) (percentile / 100.0 * histogram->num_values);
+	if (rank < histogram->num_values && rank < percentile / 100.0 * histogram->num_values) rank += 1;
+	if (rank == 0) rank = 1;
+
+	uint64_t seen = 0;
+	for (unsigned bucket = 0; bucket < HISTOGRAM_NUM_BUCKETS; ++bucket)
+	{
+		seen += histogram->counts[bucket];
+
+		if (seen >= rank)
+		{
+			// The bucket bound may exceed the largest recorded value:
+			uint64_t bound = bucket_upper_bound(bucket);
+			return (bound < histogram->max)? bound : histogram->max;
+		}
+	}
+
+	return histogram->max;
+}
@@ -0,0 +1,38 @@
+#ifndef LATENCY_HISTOGRAM_HPP_INCLUDED
+#define LATENCY_HISTOGRAM_HPP_INCLUDED
+
+#include <stdint.h>
+
+//------------------------------------------------------------------
+// Latency histogram (HDR-style)
+//------------------------------------------------------------------
+// Log-linear buckets: every power of two is split into
+// HISTOGRAM_SUB_BUCKETS linear sub-buckets, so any 64-bit value
+// is recorded with a relative error below 1/HISTOGRAM_SUB_BUCKETS
+// into a fixed array of counters:
+// - One histogram per thread, recording is a plain increment
+//   with no atomics and no shared cache lines
+// - Per-thread histograms are merged after the threads are joined
+//------------------------------------------------------------------
+
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+#define HISTOGRAM_SUB_BUCKETS     (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_NUM_BUCKETS     ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+struct LatencyHistogram
+{
+	uint64_t num_values;
+	uint64_t sum;
+	uint64_t max;
+
+	uint64_t counts[HISTOGRAM_NUM_BUCKETS];
+};
+
+void histogram_reset (struct LatencyHistogram* histogram);
+void histogram_record(struct LatencyHistogram* histogram, uint64_t value);
+void histogram_merge (struct LatencyHistogram* to, const struct LatencyHistogram* from);
+
+// Upper bound of the bucket holding the given percentile (0.0 .. 100.0):
+uint64_t histogram_percentile(const struct LatencyHistogram* histogram, double percentile);
+
+#endif // LATENCY_HISTOGRAM_HPP_INCLUDED
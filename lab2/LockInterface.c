@@ -0,0 +1,870 @@
+#define _GNU_SOURCE
+
+#include "LockInterface.h"
+#include "SpinLocks.h"
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+//------------------
+// Lock object model
+//------------------
+
+int lock_create(struct Lock* lock, const struct LockOps* ops)
+{
+	// aligned_alloc() wants the size to be a multiple of the alignment:
+	size_t size = (ops->size + ops->alignment - 1) / ops->alignment * ops->alignment;
+
+	void* instance = aligned_alloc(ops->alignment, size);
+	if (instance == NULL) return -1;
+
+	if (ops->init(instance) != 0)
+	{
+		free(instance);
+		return -1;
+	}
+
+	lock->ops      = ops;
+	lock->instance = instance;
+
+	return 0;
+}
+
+void lock_destroy(struct Lock* lock)
+{
+	if (lock->ops->destroy != NULL) lock->ops->destroy(lock->instance);
+
+	free(lock->instance);
+
+	lock->instance = NULL;
+}
+
+int lock_create_array(struct Lock* locks, size_t num_locks, const struct LockOps* ops)
+{
+	// sizeof() of a lock type is a multiple of its alignment, so this is the array stride:
+	size_t stride = ops->size;
+
+	size_t alignment = (ops->alignment > L1D_LINESIZE)? ops->alignment : L1D_LINESIZE;
+	size_t size      = (stride * num_locks + alignment - 1) / alignment * alignment;
+
+	char* instances = aligned_alloc(alignment, size);
+	if (instances == NULL) return -1;
+
+	for (size_t lock_i = 0; lock_i < num_locks; ++lock_i)
+	{
+		void* instance = instances + lock_i * stride;
+
+		if (ops->init(instance) != 0)
+		{
+			// Undo the instances already initialized:
+			while (lock_i-- > 0)
+			{
+				if (ops->destroy != NULL) ops->destroy(locks[lock_i].instance);
+			}
+
+			free(instances);
+			return -1;
+		}
+
+		locks[lock_i].ops      = ops;
+		locks[lock_i].instance = instance;
+	}
+
+	return 0;
+}
+
+void lock_destroy_array(struct Lock* locks, size_t num_locks)
+{
+	if (num_locks == 0) return;
+
+	for (size_t lock_i = 0; lock_i < num_locks; ++lock_i)
+	{
+		if (locks[lock_i].ops->destroy != NULL) locks[lock_i].ops->destroy(locks[lock_i].instance);
+	}
+
+	// The first instance is the start of the allocation:
+	free(locks[0].instance);
+
+	for (size_t lock_i = 0; lock_i < num_locks; ++lock_i)
+	{
+		locks[lock_i].instance = NULL;
+	}
+}
+
+static unsigned long long monotonic_ns()
+{
+	struct timespec now;
+
+	// No value-checking, CLOCK_MONOTONIC is always supported:
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+int lock_acquire_for(struct Lock* lock, unsigned long long timeout_ns)
+{
+	if (lock->ops->acquire_for != NULL)
+	{
+		return lock->ops->acquire_for(lock->instance, timeout_ns);
+	}
+
+	// Delegation locks:
+	if (lock->ops->try_acquire == NULL) return 0;
+
+	// Poll try_acquire() until the deadline:
+	unsigned long long deadline = monotonic_ns() + timeout_ns;
+
+	while (!lock->ops->try_acquire(lock->instance))
+	{
+		if (monotonic_ns() >= deadline) return 0;
+
+		sched_yield();
+	}
+
+	return 1;
+}
+
+void lock_execute(struct Lock* lock, void (*critical_section)(void*), void* argument)
+{
+	if (lock->ops->execute != NULL)
+	{
+		lock->ops->execute(lock->instance, critical_section, argument);
+		return;
+	}
+
+	lock->ops->acquire(lock->instance);
+
+	critical_section(argument);
+
+	lock->ops->release(lock->instance);
+}
+
+//-----------------------
+// Locks from SpinLocks.h
+//-----------------------
+
+// Operations that take the instance as is:
+#define LOCK_OPS_ADAPTERS(prefix, type)                                                  \
+	static void prefix##_ops_acquire(void* instance)                                     \
+	{                                                                                    \
+		prefix##_acquire((struct type*) instance);                                       \
+	}                                                                                    \
+	static int prefix##_ops_try_acquire(void* instance)                                  \
+	{                                                                                    \
+		return prefix##_try_acquire((struct type*) instance);                            \
+	}                                                                                    \
+	static int prefix##_ops_acquire_for(void* instance, unsigned long long timeout_ns)   \
+	{                                                                                    \
+		return prefix##_acquire_for((struct type*) instance, timeout_ns);                \
+	}                                                                                    \
+	static void prefix##_ops_release(void* instance)                                     \
+	{                                                                                    \
+		prefix##_release((struct type*) instance);                                       \
+	}
+
+#define RW_LOCK_OPS_ADAPTERS(prefix, type)                                               \
+	static void prefix##_ops_read_acquire(void* instance)                                \
+	{                                                                                    \
+		prefix##_read_acquire((struct type*) instance);                                  \
+	}                                                                                    \
+	static void prefix##_ops_read_release(void* instance)                                \
+	{                                                                                    \
+		prefix##_read_release((struct type*) instance);                                  \
+	}                                                                                    \
+	static void prefix##_ops_write_acquire(void* instance)                               \
+	{                                                                                    \
+		prefix##_write_acquire((struct type*) instance);                                 \
+	}                                                                                    \
+	static int prefix##_ops_write_try_acquire(void* instance)                            \
+	{                                                                                    \
+		return prefix##_write_try_acquire((struct type*) instance);                      \
+	}                                                                                    \
+	static void prefix##_ops_write_release(void* instance)                               \
+	{                                                                                    \
+		prefix##_write_release((struct type*) instance);                                 \
+	}
+
+LOCK_OPS_ADAPTERS(TAS,             TAS_Lock)
+LOCK_OPS_ADAPTERS(TTAS,            TTAS_Lock)
+LOCK_OPS_ADAPTERS(TicketLock,      TicketLock)
+LOCK_OPS_ADAPTERS(SplitTicketLock, SplitTicketLock)
+LOCK_OPS_ADAPTERS(CLH,             CLH_Lock)
+LOCK_OPS_ADAPTERS(AndersonLock,    AndersonLock)
+LOCK_OPS_ADAPTERS(CohortLock,      CohortLock)
+LOCK_OPS_ADAPTERS(HybridLock,      HybridLock)
+LOCK_OPS_ADAPTERS(AdaptiveLock,    AdaptiveLock)
+
+RW_LOCK_OPS_ADAPTERS(RWLock,            RWLock)
+RW_LOCK_OPS_ADAPTERS(PhaseFairRWLock,   PhaseFairRWLock)
+RW_LOCK_OPS_ADAPTERS(DistributedRWLock, DistributedRWLock)
+
+static int TAS_ops_init(void* instance)
+{
+	TAS_init((struct TAS_Lock*) instance);
+	return 0;
+}
+
+static int TTAS_ops_init(void* instance)
+{
+	TTAS_init((struct TTAS_Lock*) instance);
+	return 0;
+}
+
+static int TicketLock_ops_init(void* instance)
+{
+	TicketLock_init((struct TicketLock*) instance);
+	return 0;
+}
+
+static int SplitTicketLock_ops_init(void* instance)
+{
+	SplitTicketLock_init((struct SplitTicketLock*) instance);
+	return 0;
+}
+
+static int CLH_ops_init(void* instance)
+{
+	return CLH_init((struct CLH_Lock*) instance);
+}
+
+static void CLH_ops_destroy(void* instance)
+{
+	CLH_destroy((struct CLH_Lock*) instance);
+}
+
+static int AndersonLock_ops_init(void* instance)
+{
+	return AndersonLock_init((struct AndersonLock*) instance, ANDERSON_DEFAULT_CAPACITY);
+}
+
+static void AndersonLock_ops_destroy(void* instance)
+{
+	AndersonLock_destroy((struct AndersonLock*) instance);
+}
+
+// No timed acquisition of its own, lock_acquire_for() polls try_acquire:
+static int TimePublishedLock_ops_init(void* instance)
+{
+	TimePublishedLock_init((struct TimePublishedLock*) instance);
+	return 0;
+}
+
+static void TimePublishedLock_ops_acquire(void* instance)
+{
+	TimePublishedLock_acquire((struct TimePublishedLock*) instance);
+}
+
+static int TimePublishedLock_ops_try_acquire(void* instance)
+{
+	return TimePublishedLock_try_acquire((struct TimePublishedLock*) instance);
+}
+
+static void TimePublishedLock_ops_release(void* instance)
+{
+	TimePublishedLock_release((struct TimePublishedLock*) instance);
+}
+
+static int CohortLock_ops_init(void* instance)
+{
+	return CohortLock_init((struct CohortLock*) instance);
+}
+
+static void CohortLock_ops_destroy(void* instance)
+{
+	CohortLock_destroy((struct CohortLock*) instance);
+}
+
+static int HybridLock_ops_init(void* instance)
+{
+	HybridLock_init((struct HybridLock*) instance);
+	return 0;
+}
+
+static int AdaptiveLock_ops_init(void* instance)
+{
+	AdaptiveLock_init((struct AdaptiveLock*) instance);
+	return 0;
+}
+
+static int BiasedLock_ops_init(void* instance)
+{
+	BiasedLock_init((struct BiasedLock*) instance);
+	return 0;
+}
+
+static void BiasedLock_ops_acquire(void* instance)
+{
+	BiasedLock_acquire((struct BiasedLock*) instance);
+}
+
+static int BiasedLock_ops_try_acquire(void* instance)
+{
+	return BiasedLock_try_acquire((struct BiasedLock*) instance);
+}
+
+static void BiasedLock_ops_release(void* instance)
+{
+	BiasedLock_release((struct BiasedLock*) instance);
+}
+
+static int RWLock_ops_init(void* instance)
+{
+	RWLock_init((struct RWLock*) instance);
+	return 0;
+}
+
+static int PhaseFairRWLock_ops_init(void* instance)
+{
+	PhaseFairRWLock_init((struct PhaseFairRWLock*) instance);
+	return 0;
+}
+
+static int DistributedRWLock_ops_init(void* instance)
+{
+	return DistributedRWLock_init((struct DistributedRWLock*) instance);
+}
+
+static void DistributedRWLock_ops_destroy(void* instance)
+{
+	DistributedRWLock_destroy((struct DistributedRWLock*) instance);
+}
+
+static int FlatCombiningLock_ops_init(void* instance)
+{
+	return FlatCombiningLock_init((struct FlatCombiningLock*) instance);
+}
+
+static void FlatCombiningLock_ops_execute(void* instance, void (*critical_section)(void*), void* argument)
+{
+	FlatCombiningLock_execute((struct FlatCombiningLock*) instance, critical_section, argument);
+}
+
+static void FlatCombiningLock_ops_destroy(void* instance)
+{
+	FlatCombiningLock_destroy((struct FlatCombiningLock*) instance);
+}
+
+static int DelegationLock_ops_init(void* instance)
+{
+	return DelegationLock_init((struct DelegationLock*) instance);
+}
+
+static void DelegationLock_ops_execute(void* instance, void (*critical_section)(void*), void* argument)
+{
+	DelegationLock_execute((struct DelegationLock*) instance, critical_section, argument);
+}
+
+static void DelegationLock_ops_destroy(void* instance)
+{
+	DelegationLock_destroy((struct DelegationLock*) instance);
+}
+
+static int DelegationLock_ops_reserved_cpu(void* instance)
+{
+	return ((struct DelegationLock*) instance)->server_cpu;
+}
+
+const struct LockOps TAS_LOCK_OPS =
+{
+	.name        = "TAS lock",
+	.size        = sizeof (struct TAS_Lock),
+	.alignment   = _Alignof(struct TAS_Lock),
+	.init        = TAS_ops_init,
+	.acquire     = TAS_ops_acquire,
+	.try_acquire = TAS_ops_try_acquire,
+	.acquire_for = TAS_ops_acquire_for,
+	.release     = TAS_ops_release
+};
+
+const struct LockOps TTAS_LOCK_OPS =
+{
+	.name        = "TTAS lock",
+	.size        = sizeof (struct TTAS_Lock),
+	.alignment   = _Alignof(struct TTAS_Lock),
+	.init        = TTAS_ops_init,
+	.acquire     = TTAS_ops_acquire,
+	.try_acquire = TTAS_ops_try_acquire,
+	.acquire_for = TTAS_ops_acquire_for,
+	.release     = TTAS_ops_release
+};
+
+const struct LockOps TICKET_LOCK_OPS =
+{
+	.name        = "Ticket lock",
+	.size        = sizeof (struct TicketLock),
+	.alignment   = _Alignof(struct TicketLock),
+	.init        = TicketLock_ops_init,
+	.acquire     = TicketLock_ops_acquire,
+	.try_acquire = TicketLock_ops_try_acquire,
+	.acquire_for = TicketLock_ops_acquire_for,
+	.release     = TicketLock_ops_release
+};
+
+// The padded layouts start with the plain lock, so they share its operations:
+
+const struct LockOps TAS_PADDED_LOCK_OPS =
+{
+	.name        = "TAS lock (padded)",
+	.size        = sizeof (struct TAS_PaddedLock),
+	.alignment   = _Alignof(struct TAS_PaddedLock),
+	.init        = TAS_ops_init,
+	.acquire     = TAS_ops_acquire,
+	.try_acquire = TAS_ops_try_acquire,
+	.acquire_for = TAS_ops_acquire_for,
+	.release     = TAS_ops_release
+};
+
+const struct LockOps TTAS_PADDED_LOCK_OPS =
+{
+	.name        = "TTAS lock (padded)",
+	.size        = sizeof (struct TTAS_PaddedLock),
+	.alignment   = _Alignof(struct TTAS_PaddedLock),
+	.init        = TTAS_ops_init,
+	.acquire     = TTAS_ops_acquire,
+	.try_acquire = TTAS_ops_try_acquire,
+	.acquire_for = TTAS_ops_acquire_for,
+	.release     = TTAS_ops_release
+};
+
+const struct LockOps TICKET_PADDED_LOCK_OPS =
+{
+	.name        = "Ticket lock (padded)",
+	.size        = sizeof (struct TicketPaddedLock),
+	.alignment   = _Alignof(struct TicketPaddedLock),
+	.init        = TicketLock_ops_init,
+	.acquire     = TicketLock_ops_acquire,
+	.try_acquire = TicketLock_ops_try_acquire,
+	.acquire_for = TicketLock_ops_acquire_for,
+	.release     = TicketLock_ops_release
+};
+
+const struct LockOps SPLIT_TICKET_LOCK_OPS =
+{
+	.name        = "Ticket lock (split counters)",
+	.size        = sizeof (struct SplitTicketLock),
+	.alignment   = _Alignof(struct SplitTicketLock),
+	.init        = SplitTicketLock_ops_init,
+	.acquire     = SplitTicketLock_ops_acquire,
+	.try_acquire = SplitTicketLock_ops_try_acquire,
+	.acquire_for = SplitTicketLock_ops_acquire_for,
+	.release     = SplitTicketLock_ops_release
+};
+
+const struct LockOps CLH_LOCK_OPS =
+{
+	.name        = "CLH lock",
+	.size        = sizeof (struct CLH_Lock),
+	.alignment   = _Alignof(struct CLH_Lock),
+	.init        = CLH_ops_init,
+	.acquire     = CLH_ops_acquire,
+	.try_acquire = CLH_ops_try_acquire,
+	.acquire_for = CLH_ops_acquire_for,
+	.release     = CLH_ops_release,
+	.destroy     = CLH_ops_destroy
+};
+
+const struct LockOps ANDERSON_LOCK_OPS =
+{
+	.name        = "Anderson array lock",
+	.size        = sizeof (struct AndersonLock),
+	.alignment   = _Alignof(struct AndersonLock),
+	.init        = AndersonLock_ops_init,
+	.acquire     = AndersonLock_ops_acquire,
+	.try_acquire = AndersonLock_ops_try_acquire,
+	.acquire_for = AndersonLock_ops_acquire_for,
+	.release     = AndersonLock_ops_release,
+	.destroy     = AndersonLock_ops_destroy
+};
+
+const struct LockOps TIME_PUBLISHED_LOCK_OPS =
+{
+	.name        = "Time-published queue lock",
+	.size        = sizeof (struct TimePublishedLock),
+	.alignment   = _Alignof(struct TimePublishedLock),
+	.init        = TimePublishedLock_ops_init,
+	.acquire     = TimePublishedLock_ops_acquire,
+	.try_acquire = TimePublishedLock_ops_try_acquire,
+	.release     = TimePublishedLock_ops_release
+};
+
+const struct LockOps COHORT_LOCK_OPS =
+{
+	.name        = "Cohort lock",
+	.size        = sizeof (struct CohortLock),
+	.alignment   = _Alignof(struct CohortLock),
+	.init        = CohortLock_ops_init,
+	.acquire     = CohortLock_ops_acquire,
+	.try_acquire = CohortLock_ops_try_acquire,
+	.acquire_for = CohortLock_ops_acquire_for,
+	.release     = CohortLock_ops_release,
+	.destroy     = CohortLock_ops_destroy
+};
+
+const struct LockOps HYBRID_LOCK_OPS =
+{
+	.name        = "Hybrid lock",
+	.size        = sizeof (struct HybridLock),
+	.alignment   = _Alignof(struct HybridLock),
+	.init        = HybridLock_ops_init,
+	.acquire     = HybridLock_ops_acquire,
+	.try_acquire = HybridLock_ops_try_acquire,
+	.acquire_for = HybridLock_ops_acquire_for,
+	.release     = HybridLock_ops_release
+};
+
+const struct LockOps BIASED_LOCK_OPS =
+{
+	.name        = "Biased lock",
+	.size        = sizeof (struct BiasedLock),
+	.alignment   = _Alignof(struct BiasedLock),
+	.init        = BiasedLock_ops_init,
+	.acquire     = BiasedLock_ops_acquire,
+	.try_acquire = BiasedLock_ops_try_acquire,
+	.release     = BiasedLock_ops_release
+};
+
+const struct LockOps ADAPTIVE_LOCK_OPS =
+{
+	.name        = "Adaptive lock",
+	.size        = sizeof (struct AdaptiveLock),
+	.alignment   = _Alignof(struct AdaptiveLock),
+	.init        = AdaptiveLock_ops_init,
+	.acquire     = AdaptiveLock_ops_acquire,
+	.try_acquire = AdaptiveLock_ops_try_acquire,
+	.acquire_for = AdaptiveLock_ops_acquire_for,
+	.release     = AdaptiveLock_ops_release
+};
+
+// The padded layouts start with the plain lock, so they share its operations:
+
+const struct LockOps CLH_PADDED_LOCK_OPS =
+{
+	.name        = "CLH lock (padded)",
+	.size        = sizeof (struct CLH_PaddedLock),
+	.alignment   = _Alignof(struct CLH_PaddedLock),
+	.init        = CLH_ops_init,
+	.acquire     = CLH_ops_acquire,
+	.try_acquire = CLH_ops_try_acquire,
+	.acquire_for = CLH_ops_acquire_for,
+	.release     = CLH_ops_release,
+	.destroy     = CLH_ops_destroy
+};
+
+const struct LockOps ANDERSON_PADDED_LOCK_OPS =
+{
+	.name        = "Anderson array lock (padded)",
+	.size        = sizeof (struct AndersonPaddedLock),
+	.alignment   = _Alignof(struct AndersonPaddedLock),
+	.init        = AndersonLock_ops_init,
+	.acquire     = AndersonLock_ops_acquire,
+	.try_acquire = AndersonLock_ops_try_acquire,
+	.acquire_for = AndersonLock_ops_acquire_for,
+	.release     = AndersonLock_ops_release,
+	.destroy     = AndersonLock_ops_destroy
+};
+
+const struct LockOps TIME_PUBLISHED_PADDED_LOCK_OPS =
+{
+	.name        = "Time-published queue lock (padded)",
+	.size        = sizeof (struct TimePublishedPaddedLock),
+	.alignment   = _Alignof(struct TimePublishedPaddedLock),
+	.init        = TimePublishedLock_ops_init,
+	.acquire     = TimePublishedLock_ops_acquire,
+	.try_acquire = TimePublishedLock_ops_try_acquire,
+	.release     = TimePublishedLock_ops_release
+};
+
+const struct LockOps COHORT_PADDED_LOCK_OPS =
+{
+	.name        = "Cohort lock (padded)",
+	.size        = sizeof (struct CohortPaddedLock),
+	.alignment   = _Alignof(struct CohortPaddedLock),
+	.init        = CohortLock_ops_init,
+	.acquire     = CohortLock_ops_acquire,
+	.try_acquire = CohortLock_ops_try_acquire,
+	.acquire_for = CohortLock_ops_acquire_for,
+	.release     = CohortLock_ops_release,
+	.destroy     = CohortLock_ops_destroy
+};
+
+const struct LockOps HYBRID_PADDED_LOCK_OPS =
+{
+	.name        = "Hybrid lock (padded)",
+	.size        = sizeof (struct HybridPaddedLock),
+	.alignment   = _Alignof(struct HybridPaddedLock),
+	.init        = HybridLock_ops_init,
+	.acquire     = HybridLock_ops_acquire,
+	.try_acquire = HybridLock_ops_try_acquire,
+	.acquire_for = HybridLock_ops_acquire_for,
+	.release     = HybridLock_ops_release
+};
+
+const struct LockOps ADAPTIVE_PADDED_LOCK_OPS =
+{
+	.name        = "Adaptive lock (padded)",
+	.size        = sizeof (struct AdaptivePaddedLock),
+	.alignment   = _Alignof(struct AdaptivePaddedLock),
+	.init        = AdaptiveLock_ops_init,
+	.acquire     = AdaptiveLock_ops_acquire,
+	.try_acquire = AdaptiveLock_ops_try_acquire,
+	.acquire_for = AdaptiveLock_ops_acquire_for,
+	.release     = AdaptiveLock_ops_release
+};
+
+const struct LockOps RW_LOCK_OPS =
+{
+	.name         = "Reader-writer lock",
+	.size         = sizeof (struct RWLock),
+	.alignment    = _Alignof(struct RWLock),
+	.init         = RWLock_ops_init,
+	.acquire      = RWLock_ops_write_acquire,
+	.try_acquire  = RWLock_ops_write_try_acquire,
+	.release      = RWLock_ops_write_release,
+	.read_acquire = RWLock_ops_read_acquire,
+	.read_release = RWLock_ops_read_release
+};
+
+const struct LockOps PHASE_FAIR_RW_LOCK_OPS =
+{
+	.name         = "Phase-fair reader-writer lock",
+	.size         = sizeof (struct PhaseFairRWLock),
+	.alignment    = _Alignof(struct PhaseFairRWLock),
+	.init         = PhaseFairRWLock_ops_init,
+	.acquire      = PhaseFairRWLock_ops_write_acquire,
+	.try_acquire  = PhaseFairRWLock_ops_write_try_acquire,
+	.release      = PhaseFairRWLock_ops_write_release,
+	.read_acquire = PhaseFairRWLock_ops_read_acquire,
+	.read_release = PhaseFairRWLock_ops_read_release
+};
+
+const struct LockOps DISTRIBUTED_RW_LOCK_OPS =
+{
+	.name         = "Distributed reader-writer lock",
+	.size         = sizeof (struct DistributedRWLock),
+	.alignment    = _Alignof(struct DistributedRWLock),
+	.init         = DistributedRWLock_ops_init,
+	.acquire      = DistributedRWLock_ops_write_acquire,
+	.try_acquire  = DistributedRWLock_ops_write_try_acquire,
+	.release      = DistributedRWLock_ops_write_release,
+	.destroy      = DistributedRWLock_ops_destroy,
+	.read_acquire = DistributedRWLock_ops_read_acquire,
+	.read_release = DistributedRWLock_ops_read_release
+};
+
+const struct LockOps RW_PADDED_LOCK_OPS =
+{
+	.name         = "Reader-writer lock (padded)",
+	.size         = sizeof (struct RWPaddedLock),
+	.alignment    = _Alignof(struct RWPaddedLock),
+	.init         = RWLock_ops_init,
+	.acquire      = RWLock_ops_write_acquire,
+	.try_acquire  = RWLock_ops_write_try_acquire,
+	.release      = RWLock_ops_write_release,
+	.read_acquire = RWLock_ops_read_acquire,
+	.read_release = RWLock_ops_read_release
+};
+
+const struct LockOps PHASE_FAIR_RW_PADDED_LOCK_OPS =
+{
+	.name         = "Phase-fair reader-writer lock (padded)",
+	.size         = sizeof (struct PhaseFairRWPaddedLock),
+	.alignment    = _Alignof(struct PhaseFairRWPaddedLock),
+	.init         = PhaseFairRWLock_ops_init,
+	.acquire      = PhaseFairRWLock_ops_write_acquire,
+	.try_acquire  = PhaseFairRWLock_ops_write_try_acquire,
+	.release      = PhaseFairRWLock_ops_write_release,
+	.read_acquire = PhaseFairRWLock_ops_read_acquire,
+	.read_release = PhaseFairRWLock_ops_read_release
+};
+
+const struct LockOps DISTRIBUTED_RW_PADDED_LOCK_OPS =
+{
+	.name         = "Distributed reader-writer lock (padded)",
+	.size         = sizeof (struct DistributedRWPaddedLock),
+	.alignment    = _Alignof(struct DistributedRWPaddedLock),
+	.init         = DistributedRWLock_ops_init,
+	.acquire      = DistributedRWLock_ops_write_acquire,
+	.try_acquire  = DistributedRWLock_ops_write_try_acquire,
+	.release      = DistributedRWLock_ops_write_release,
+	.destroy      = DistributedRWLock_ops_destroy,
+	.read_acquire = DistributedRWLock_ops_read_acquire,
+	.read_release = DistributedRWLock_ops_read_release
+};
+
+const struct LockOps FLAT_COMBINING_LOCK_OPS =
+{
+	.name      = "Flat-combining lock",
+	.size      = sizeof (struct FlatCombiningLock),
+	.alignment = _Alignof(struct FlatCombiningLock),
+	.init      = FlatCombiningLock_ops_init,
+	.execute   = FlatCombiningLock_ops_execute,
+	.destroy   = FlatCombiningLock_ops_destroy
+};
+
+const struct LockOps FLAT_COMBINING_PADDED_LOCK_OPS =
+{
+	.name      = "Flat-combining lock (padded)",
+	.size      = sizeof (struct FlatCombiningPaddedLock),
+	.alignment = _Alignof(struct FlatCombiningPaddedLock),
+	.init      = FlatCombiningLock_ops_init,
+	.execute   = FlatCombiningLock_ops_execute,
+	.destroy   = FlatCombiningLock_ops_destroy
+};
+
+const struct LockOps DELEGATION_LOCK_OPS =
+{
+	.name         = "Delegation lock (dedicated server)",
+	.size         = sizeof (struct DelegationLock),
+	.alignment    = _Alignof(struct DelegationLock),
+	.init         = DelegationLock_ops_init,
+	.execute      = DelegationLock_ops_execute,
+	.destroy      = DelegationLock_ops_destroy,
+	.reserved_cpu = DelegationLock_ops_reserved_cpu
+};
+
+//-----------------------
+// Baseline: pthread mutex
+//-----------------------
+
+static int pthread_mutex_ops_init(void* instance)
+{
+	return (pthread_mutex_init((pthread_mutex_t*) instance, NULL) == 0)? 0 : -1;
+}
+
+static void pthread_mutex_ops_acquire(void* instance)
+{
+	pthread_mutex_lock((pthread_mutex_t*) instance);
+}
+
+static int pthread_mutex_ops_try_acquire(void* instance)
+{
+	return pthread_mutex_trylock((pthread_mutex_t*) instance) == 0;
+}
+
+static int pthread_mutex_ops_acquire_for(void* instance, unsigned long long timeout_ns)
+{
+	// pthread_mutex_timedlock() takes an absolute CLOCK_REALTIME deadline:
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+
+	unsigned long long nsec = deadline.tv_nsec + timeout_ns;
+
+	deadline.tv_sec  += nsec / 1000000000;
+	deadline.tv_nsec  = nsec % 1000000000;
+
+	return pthread_mutex_timedlock((pthread_mutex_t*) instance, &deadline) == 0;
+}
+
+static void pthread_mutex_ops_release(void* instance)
+{
+	pthread_mutex_unlock((pthread_mutex_t*) instance);
+}
+
+static void pthread_mutex_ops_destroy(void* instance)
+{
+	pthread_mutex_destroy((pthread_mutex_t*) instance);
+}
+
+const struct LockOps PTHREAD_MUTEX_OPS =
+{
+	.name        = "pthread_mutex",
+	.size        = sizeof (pthread_mutex_t),
+	.alignment   = _Alignof(pthread_mutex_t),
+	.init        = pthread_mutex_ops_init,
+	.acquire     = pthread_mutex_ops_acquire,
+	.try_acquire = pthread_mutex_ops_try_acquire,
+	.acquire_for = pthread_mutex_ops_acquire_for,
+	.release     = pthread_mutex_ops_release,
+	.destroy     = pthread_mutex_ops_destroy
+};
+
+//--------------------------
+// Baseline: pthread spinlock
+//--------------------------
+
+static int pthread_spinlock_ops_init(void* instance)
+{
+	return (pthread_spin_init((pthread_spinlock_t*) instance, PTHREAD_PROCESS_PRIVATE) == 0)? 0 : -1;
+}
+
+static void pthread_spinlock_ops_acquire(void* instance)
+{
+	pthread_spin_lock((pthread_spinlock_t*) instance);
+}
+
+static int pthread_spinlock_ops_try_acquire(void* instance)
+{
+	return pthread_spin_trylock((pthread_spinlock_t*) instance) == 0;
+}
+
+static void pthread_spinlock_ops_release(void* instance)
+{
+	pthread_spin_unlock((pthread_spinlock_t*) instance);
+}
+
+static void pthread_spinlock_ops_destroy(void* instance)
+{
+	pthread_spin_destroy((pthread_spinlock_t*) instance);
+}
+
+const struct LockOps PTHREAD_SPINLOCK_OPS =
+{
+	.name        = "pthread_spinlock",
+	.size        = sizeof (pthread_spinlock_t),
+	.alignment   = _Alignof(pthread_spinlock_t),
+	.init        = pthread_spinlock_ops_init,
+	.acquire     = pthread_spinlock_ops_acquire,
+	.try_acquire = pthread_spinlock_ops_try_acquire,
+	.release     = pthread_spinlock_ops_release,
+	.destroy     = pthread_spinlock_ops_destroy
+};
+
+//---------------------------
+// Baseline: C11 atomic_flag
+//---------------------------
+
+struct AtomicFlagLock
+{
+	atomic_flag flag;
+};
+
+static int atomic_flag_ops_init(void* instance)
+{
+	atomic_flag_clear(&((struct AtomicFlagLock*) instance)->flag);
+	return 0;
+}
+
+static void atomic_flag_ops_acquire(void* instance)
+{
+	struct AtomicFlagLock* lock = (struct AtomicFlagLock*) instance;
+
+	while (atomic_flag_test_and_set_explicit(&lock->flag, memory_order_acquire));
+}
+
+static int atomic_flag_ops_try_acquire(void* instance)
+{
+	struct AtomicFlagLock* lock = (struct AtomicFlagLock*) instance;
+
+	return !atomic_flag_test_and_set_explicit(&lock->flag, memory_order_acquire);
+}
+
+static void atomic_flag_ops_release(void* instance)
+{
+	struct AtomicFlagLock* lock = (struct AtomicFlagLock*) instance;
+
+	atomic_flag_clear_explicit(&lock->flag, memory_order_release);
+}
+
+const struct LockOps ATOMIC_FLAG_LOCK_OPS =
+{
+	.name        = "atomic_flag lock",
+	.size        = sizeof (struct AtomicFlagLock),
+	.alignment   = _Alignof(struct AtomicFlagLock),
+	.init        = atomic_flag_ops_init,
+	.acquire     = atomic_flag_ops_acquire,
+	.try_acquire = atomic_flag_ops_try_acquire,
+	.release     = atomic_flag_ops_release
+};
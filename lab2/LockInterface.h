@@ -0,0 +1,159 @@
+#ifndef LOCK_INTERFACE_HPP_INCLUDED
+#define LOCK_INTERFACE_HPP_INCLUDED
+
+#include <stddef.h>
+
+//------------------------------------------------------------------
+// Lock object interface
+//------------------------------------------------------------------
+// Every lock is described by a table of operations over an opaque
+// instance, so any number of instances of any lock can be created
+// and passed around as one object:
+//     struct Lock lock;
+//     lock_create(&lock, &TICKET_LOCK_OPS);
+//     lock_acquire(&lock);
+//     lock_release(&lock);
+//     lock_destroy(&lock);
+// - try_acquire/acquire_for follow the convention of SpinLocks.h
+// - acquire_for may be NULL, then try_acquire is polled until
+//   the timeout expires
+// - try_acquire is set for every lock with acquire/release, delegation
+//   locks have none: lock_try_acquire() and lock_acquire_for() then
+//   fail (return 0) without touching the lock
+// - read_acquire/read_release are set for reader-writer locks only,
+//   acquire/release/try_acquire are their exclusive (writer) side
+// - execute is set for delegation locks only, which run the critical
+//   section on whatever thread combines or serves the requests and
+//   have no acquire/release; lock_execute() wraps any other lock
+// - reserved_cpu is set for locks with a thread of their own pinned
+//   to a CPU, benchmark threads keep off that CPU
+//------------------------------------------------------------------
+
+struct LockOps
+{
+	const char* name;
+
+	// Memory layout of one instance:
+	size_t size;
+	size_t alignment;
+
+	int  (*init)       (void* instance);
+	void (*acquire)    (void* instance);
+	int  (*try_acquire)(void* instance);
+	int  (*acquire_for)(void* instance, unsigned long long timeout_ns);
+	void (*release)    (void* instance);
+	void (*destroy)    (void* instance);
+
+	void (*read_acquire)(void* instance);
+	void (*read_release)(void* instance);
+
+	void (*execute)(void* instance, void (*critical_section)(void*), void* argument);
+
+	int (*reserved_cpu)(void* instance);
+};
+
+struct Lock
+{
+	const struct LockOps* ops;
+	void* instance;
+};
+
+// Allocate and init an instance, return 0 on success and -1 on failure:
+int  lock_create (struct Lock* lock, const struct LockOps* ops);
+void lock_destroy(struct Lock* lock);
+
+// Instances back to back from a cache line boundary, as in an array of the lock type,
+// so packed locks share cache lines and padded ones don't:
+int  lock_create_array (struct Lock* locks, size_t num_locks, const struct LockOps* ops);
+void lock_destroy_array(struct Lock* locks, size_t num_locks);
+
+int lock_acquire_for(struct Lock* lock, unsigned long long timeout_ns);
+
+// Run critical_section(argument) under the lock:
+void lock_execute(struct Lock* lock, void (*critical_section)(void*), void* argument);
+
+static inline void lock_acquire(struct Lock* lock)
+{
+	lock->ops->acquire(lock->instance);
+}
+
+static inline int lock_try_acquire(struct Lock* lock)
+{
+	if (lock->ops->try_acquire == NULL) return 0;
+
+	return lock->ops->try_acquire(lock->instance);
+}
+
+static inline void lock_release(struct Lock* lock)
+{
+	lock->ops->release(lock->instance);
+}
+
+// CPU taken by the lock's own thread, -1 if none:
+static inline int lock_reserved_cpu(struct Lock* lock)
+{
+	if (lock->ops->reserved_cpu == NULL) return -1;
+
+	return lock->ops->reserved_cpu(lock->instance);
+}
+
+static inline void lock_read_acquire(struct Lock* lock)
+{
+	lock->ops->read_acquire(lock->instance);
+}
+
+static inline void lock_read_release(struct Lock* lock)
+{
+	lock->ops->read_release(lock->instance);
+}
+
+//-----------------------
+// Locks from SpinLocks.h
+//-----------------------
+
+extern const struct LockOps TAS_LOCK_OPS;
+extern const struct LockOps TTAS_LOCK_OPS;
+extern const struct LockOps TICKET_LOCK_OPS;
+extern const struct LockOps TAS_PADDED_LOCK_OPS;
+extern const struct LockOps TTAS_PADDED_LOCK_OPS;
+extern const struct LockOps TICKET_PADDED_LOCK_OPS;
+extern const struct LockOps SPLIT_TICKET_LOCK_OPS;
+extern const struct LockOps CLH_LOCK_OPS;
+extern const struct LockOps ANDERSON_LOCK_OPS;
+extern const struct LockOps TIME_PUBLISHED_LOCK_OPS;
+extern const struct LockOps COHORT_LOCK_OPS;
+extern const struct LockOps HYBRID_LOCK_OPS;
+extern const struct LockOps BIASED_LOCK_OPS;
+extern const struct LockOps ADAPTIVE_LOCK_OPS;
+extern const struct LockOps CLH_PADDED_LOCK_OPS;
+extern const struct LockOps ANDERSON_PADDED_LOCK_OPS;
+extern const struct LockOps TIME_PUBLISHED_PADDED_LOCK_OPS;
+extern const struct LockOps COHORT_PADDED_LOCK_OPS;
+extern const struct LockOps HYBRID_PADDED_LOCK_OPS;
+extern const struct LockOps ADAPTIVE_PADDED_LOCK_OPS;
+
+extern const struct LockOps RW_LOCK_OPS;
+extern const struct LockOps PHASE_FAIR_RW_LOCK_OPS;
+extern const struct LockOps DISTRIBUTED_RW_LOCK_OPS;
+extern const struct LockOps RW_PADDED_LOCK_OPS;
+extern const struct LockOps PHASE_FAIR_RW_PADDED_LOCK_OPS;
+extern const struct LockOps DISTRIBUTED_RW_PADDED_LOCK_OPS;
+
+extern const struct LockOps FLAT_COMBINING_LOCK_OPS;
+extern const struct LockOps DELEGATION_LOCK_OPS;
+extern const struct LockOps FLAT_COMBINING_PADDED_LOCK_OPS;
+
+//------------------------------------------------------------------
+// Baselines
+//------------------------------------------------------------------
+// What the platform already gives us, every lock is compared to:
+// - pthread_mutex_t (futex-based, parks contended waiters)
+// - pthread_spinlock_t (plain spinning)
+// - C11 atomic_flag test-and-set loop without any backoff
+//------------------------------------------------------------------
+
+extern const struct LockOps PTHREAD_MUTEX_OPS;
+extern const struct LockOps PTHREAD_SPINLOCK_OPS;
+extern const struct LockOps ATOMIC_FLAG_LOCK_OPS;
+
+#endif // LOCK_INTERFACE_HPP_INCLUDED
@@ -0,0 +1,159 @@
+#include "LockStats.h"
+#include "SpinLocks.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef LOCK_STATS
+
+//-----------------
+// Thread registry
+//-----------------
+
+struct LockStatsBlock
+{
+	struct LockStats stats;
+
+	struct LockStatsBlock* next;
+} CACHE_LINE_ALIGNED;
+
+_Thread_local struct LockStats* lock_stats_thread_counters = NULL;
+
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct LockStatsBlock* live_blocks = NULL;
+static struct LockStats       retired;
+
+static pthread_once_t exit_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  exit_key;
+
+static void add_stats(struct LockStats* to, const struct LockStats* from)
+{
+	to->num_spins          += __atomic_load_n(&from->num_spins,          __ATOMIC_RELAXED);
+	to->num_sleeps         += __atomic_load_n(&from->num_sleeps,         __ATOMIC_RELAXED);
+	to->sleep_ns           += __atomic_load_n(&from->sleep_ns,           __ATOMIC_RELAXED);
+	to->num_yields         += __atomic_load_n(&from->num_yields,         __ATOMIC_RELAXED);
+	to->num_failed_atomics += __atomic_load_n(&from->num_failed_atomics, __ATOMIC_RELAXED);
+	to->num_handoffs       += __atomic_load_n(&from->num_handoffs,       __ATOMIC_RELAXED);
+	to->handoff_cycles     += __atomic_load_n(&from->handoff_cycles,     __ATOMIC_RELAXED);
+}
+
+// Thread-exit destructor: fold the block into the retired total and unlink it:
+static void retire_block(void* arg)
+{
+	struct LockStatsBlock* block = (struct LockStatsBlock*) arg;
+
+	pthread_mutex_lock(&registry_mutex);
+
+	add_stats(&retired, &block->stats);
+
+	struct LockStatsBlock** link = &live_blocks;
+	while (*link != block) link = &(*link)->next;
+
+	*link = block->next;
+
+	pthread_mutex_unlock(&registry_mutex);
+
+	free(block);
+
+	lock_stats_thread_counters = NULL;
+}
+
+static void create_exit_key()
+{
+	if (pthread_key_create(&exit_key, retire_block) != 0)
+	{
+		fprintf(stderr, "[Error] Unable to create lock statistics key\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+struct LockStats* lock_stats_register_thread()
+{
+	pthread_once(&exit_key_once, create_exit_key);
+
+	struct LockStatsBlock* block = aligned_alloc(L1D_LINESIZE, sizeof(struct LockStatsBlock));
+	if (block == NULL)
+	{
+		fprintf(stderr, "[Error] Unable to allocate lock statistics\n");
+		exit(EXIT_FAILURE);
+	}
+
+	memset(&block->stats, 0, sizeof(block->stats));
+
+	pthread_mutex_lock(&registry_mutex);
+
+	block->next = live_blocks;
+	live_blocks = block;
+
+	pthread_mutex_unlock(&registry_mutex);
+
+	pthread_setspecific(exit_key, block);
+
+	lock_stats_thread_counters = &block->stats;
+
+	return lock_stats_thread_counters;
+}
+
+//--------------
+// Snapshot API
+//--------------
+
+int lock_stats_enabled()
+{
+	return 1;
+}
+
+void lock_stats_snapshot(struct LockStats* stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	pthread_mutex_lock(&registry_mutex);
+
+	add_stats(stats, &retired);
+
+	for (struct LockStatsBlock* block = live_blocks; block != NULL; block = block->next)
+	{
+		add_stats(stats, &block->stats);
+	}
+
+	pthread_mutex_unlock(&registry_mutex);
+}
+
+void lock_stats_reset()
+{
+	pthread_mutex_lock(&registry_mutex);
+
+	memset(&retired, 0, sizeof(retired));
+
+	for (struct LockStatsBlock* block = live_blocks; block != NULL; block = block->next)
+	{
+		memset(&block->stats, 0, sizeof(block->stats));
+	}
+
+	pthread_mutex_unlock(&registry_mutex);
+}
+
+#else
+
+//--------------------------------
+// Snapshot API (not instrumented)
+//--------------------------------
+
+int lock_stats_enabled()
+{
+	return 0;
+}
+
+void lock_stats_snapshot(struct LockStats* stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+void lock_stats_reset()
+{
+}
+
+#endif // LOCK_STATS
@@ -0,0 +1,79 @@
+#ifndef LOCK_STATS_HPP_INCLUDED
+#define LOCK_STATS_HPP_INCLUDED
+
+//------------------------------------------------------------------
+// Lock instrumentation
+//------------------------------------------------------------------
+// Opt-in: SpinLocks.c counts only if built with -D LOCK_STATS
+// (make STATS=1), otherwise every hook compiles to nothing.
+// - Every thread counts into its own cache-line-aligned block,
+//   the hot path has no shared writes and no atomic read-modify-write
+// - Blocks of exited threads are folded into a retired total
+// - A snapshot sums the retired total and every live block
+//------------------------------------------------------------------
+
+struct LockStats
+{
+	// Busy-waiting iterations ("pause" instructions):
+	unsigned long long num_spins;
+
+	// Backoff sleeps and futex waits, and the time spent in them:
+	unsigned long long num_sleeps;
+	unsigned long long sleep_ns;
+
+	unsigned long long num_yields;
+
+	// Failed test-and-set, exchange and compare-and-swap attempts:
+	unsigned long long num_failed_atomics;
+
+	// Acquisitions that waited for a release, and the TSC cycles
+	// from that release to the new owner taking the lock:
+	unsigned long long num_handoffs;
+	unsigned long long handoff_cycles;
+};
+
+// 1 if the locks are built with instrumentation:
+int lock_stats_enabled();
+
+// Sum of the counters of all threads since the last reset:
+void lock_stats_snapshot(struct LockStats* stats);
+
+// Only call while no thread is using the locks:
+void lock_stats_reset();
+
+#ifdef LOCK_STATS
+
+#include <stddef.h>
+
+extern _Thread_local struct LockStats* lock_stats_thread_counters;
+
+struct LockStats* lock_stats_register_thread();
+
+static inline struct LockStats* lock_stats_local()
+{
+	struct LockStats* stats = lock_stats_thread_counters;
+
+	return (stats != NULL)? stats : lock_stats_register_thread();
+}
+
+// Single writer, the store is atomic only for the sake of snapshot readers:
+#define LOCK_STATS_ADD(counter, value)                                                     \
+	do                                                                                     \
+	{                                                                                      \
+		struct LockStats* lock_stats_ = lock_stats_local();                                \
+		__atomic_store_n(&lock_stats_->counter, lock_stats_->counter + (value), __ATOMIC_RELAXED); \
+	} while (0)
+
+// Time of the last release, kept next to the word the next owner waits on
+// (the lock word, or the queue node or slot of a queue lock):
+#define LOCK_STATS_FIELDS volatile unsigned long long stats_released_at;
+
+#else
+
+#define LOCK_STATS_ADD(counter, value) do {} while (0)
+
+#define LOCK_STATS_FIELDS
+
+#endif // LOCK_STATS
+
+#endif // LOCK_STATS_HPP_INCLUDED
@@ -2,21 +2,32 @@
 // Multithreaded Programming
 // Lab#02: Spin-lock Benchmarking
 
+#define _GNU_SOURCE
 
 #include "SpinLockBenchmarks.h"
+#include "SpinLocks.h"
+#include "LockInterface.h"
+#include "LatencyHistogram.h"
+#include "LockStats.h"
+#include "Topology.h"
+#include "FastRandom.h"
+#include "Barriers.h"
 
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 
 //----------------------
 // Benchmark properties 
 //----------------------
 
-const int MAX_THREADS = 100; 
-const int THREAD_STEP =  10; 
+// The thread sweep covers the online CPUs in about SWEEP_NUM_STEPS steps,
+// but goes up to at least SWEEP_MIN_MAX_THREADS, so small machines get contention too:
+const size_t SWEEP_NUM_STEPS       = 8;
+const size_t SWEEP_MIN_MAX_THREADS = 8;
 
 const long CORRECTNESS_TEST_NUM_REPEATS          = 1;
 const long CORRECTNESS_TEST_NUM_LOCK_ACQISITIONS = 100;
@@ -30,22 +41,115 @@ const long FAIRNESS_TEST_NUM_REPEATS          = 100;
 const long FAIRNESS_TEST_NUM_LOCK_ACQISITIONS = 1;
 const long FAIRNESS_TEST_NUMBER_OF_CYCLES     = 10000;
 
+const long OVERSUBSCRIPTION_TEST_NUM_REPEATS          = 1;
+const long OVERSUBSCRIPTION_TEST_NUM_LOCK_ACQISITIONS = 1000;
+const long OVERSUBSCRIPTION_TEST_NUMBER_OF_CYCLES     = 10;
+const long OVERSUBSCRIPTION_TEST_MAX_FACTOR           = 4;
+
+const long OVERSUBSCRIBED_LATENCY_TEST_NUM_REPEATS          = 10;
+const long OVERSUBSCRIBED_LATENCY_TEST_NUM_LOCK_ACQISITIONS = 1000;
+const long OVERSUBSCRIBED_LATENCY_TEST_NUMBER_OF_CYCLES     = 10;
+const long OVERSUBSCRIBED_LATENCY_TEST_MIN_FACTOR           = 2;
+const long OVERSUBSCRIBED_LATENCY_TEST_MAX_FACTOR           = 4;
+
+const long SKEWED_TEST_NUM_ACQUISITIONS = 100000;
+
+const long CS_SWEEP_TEST_NUM_REPEATS          = 1;
+const long CS_SWEEP_TEST_NUM_LOCK_ACQISITIONS = 1000;
+
+#define ADJACENT_TEST_NUM_LOCKS 4
+
+const long ADJACENT_TEST_NUM_LOCK_ACQISITIONS = 1000;
+const long ADJACENT_TEST_NUMBER_OF_CYCLES     = 10;
+
+const long TIMED_TEST_NUM_REPEATS          = 1;
+const long TIMED_TEST_NUM_LOCK_ACQISITIONS = 1000;
+const long TIMED_TEST_NUMBER_OF_CYCLES     = 10;
+
+const double THROUGHPUT_TEST_DURATION_SECONDS = 0.1;
+const long   THROUGHPUT_TEST_NUMBER_OF_CYCLES = 10;
+
+const double WORKLOAD_TEST_DURATION_SECONDS = 0.1;
+const long   WORKLOAD_TEST_NUMBER_OF_CYCLES = 1;
+
+const double DELEGATION_TEST_DURATION_SECONDS = 0.1;
+const long   DELEGATION_TEST_NUMBER_OF_CYCLES = 1;
+const size_t DELEGATION_TEST_MIN_THREADS      = 8;
+const size_t DELEGATION_TEST_MAX_THREADS      = 128;
+const size_t DELEGATION_TEST_THREAD_STEP      = 8;
+
+const long SEQLOCK_TEST_NUM_ACCESSES = 10000;
+
+const long BARRIER_TEST_NUM_CROSSINGS = 1000;
+
 //------------------
 // Common benchmark 
 //------------------
 
 struct CommonTestArgs
 {
-	void (*acquire_lock)();
-	void (*release_lock)();
+	struct Lock* lock;
+
+	// Timed acquisitions (instead of lock_acquire() if set):
+	int timed;
+	unsigned long long timeout_ns;
+
+	// Shared acquisitions (reader-writer locks only):
+	unsigned read_percent;
+
+	// Hand the critical section to lock_execute() (instead of lock_acquire() if set):
+	int delegate;
+
+	// Time every exclusive acquisition into the per-thread histograms:
+	int measure_latency;
+
+	// Each exclusive critical section also increments every shared line,
+	// every acquisition is preceded by a think time uniform in [0, 2*mean_think_ns]:
+	struct SharedLine* shared_lines;
+	unsigned num_shared_lines;
+	unsigned mean_think_ns;
 
 	unsigned num_lock_acuisitions;
 	unsigned num_cycles_per_thread;
 	unsigned num_runs;
 
+	// Fixed-duration mode (instead of num_lock_acuisitions if set):
+	double duration_seconds;
+	volatile int stop;
+
+	// Workers and the spawning thread start together:
+	struct SenseBarrier start_barrier;
+
+	// Threads are pinned to CPUs in this order:
+	enum TopologyPlacement placement;
+
+	// Thread count sweep (default_thread_sweep() if not set):
+	size_t min_threads;
+	size_t max_threads;
+	size_t thread_step;
+
 	unsigned long number_to_increment;
+	unsigned long num_torn_reads;
+	unsigned long num_timeouts;
 };
 
+// Spread read_percent reads evenly over the acquisitions of a thread:
+int is_read_acquisition(size_t acqisition, unsigned read_percent)
+{
+	return (acqisition + 1) * read_percent / 100 != acqisition * read_percent / 100;
+}
+
+size_t num_write_acquisitions(size_t num_acqisitions, unsigned read_percent)
+{
+	return num_acqisitions - num_acqisitions * read_percent / 100;
+}
+
+// One counter per cache line, so the critical section touches distinct lines:
+struct SharedLine
+{
+	volatile unsigned long value;
+} CACHE_LINE_ALIGNED;
+
 struct TestArgs
 {
 	struct CommonTestArgs* common;
@@ -53,13 +157,82 @@ struct TestArgs
 	pthread_t thread_id;
 
 	double thread_execution_time;
+	unsigned long num_acquisitions;
+
+	struct LatencyHistogram latency;
+
+	struct BarrierThread barrier_thread;
 };
 
+void default_thread_sweep(size_t* min_threads, size_t* max_threads, size_t* thread_step)
+{
+	size_t num_cpus = topology_num_cpus();
+
+	*max_threads = (num_cpus > SWEEP_MIN_MAX_THREADS)? num_cpus : SWEEP_MIN_MAX_THREADS;
+	*thread_step = (*max_threads + SWEEP_NUM_STEPS - 1) / SWEEP_NUM_STEPS;
+	*min_threads = *thread_step;
+
+	// End the sweep on a whole step:
+	*max_threads = (*max_threads + *thread_step - 1) / *thread_step * *thread_step;
+}
+
+// Not slewed by NTP, unlike CLOCK_MONOTONIC:
+static uint64_t monotonic_raw_ns()
+{
+	struct timespec now;
+
+	// No value-checking, CLOCK_MONOTONIC_RAW is supported since Linux 2.6.28:
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// Non-critical work between acquisitions:
+void think(struct CommonTestArgs* common_args)
+{
+	if (common_args->mean_think_ns == 0) return;
+
+	uint64_t think_ns = fast_random_below(2 * common_args->mean_think_ns + 1);
+	uint64_t finish   = monotonic_raw_ns() + think_ns;
+
+	while (monotonic_raw_ns() < finish);
+}
+
+// The loop either does a fixed number of acquisitions or runs until stopped:
+int acquisitions_done(struct CommonTestArgs* common_args, size_t acqisition)
+{
+	if (common_args->duration_seconds != 0.0)
+	{
+		return __atomic_load_n(&common_args->stop, __ATOMIC_RELAXED);
+	}
+
+	return acqisition >= common_args->num_lock_acuisitions;
+}
+
+// Exclusive critical section, runs under the lock or is delegated to lock_execute():
+void critical_section(void* args)
+{
+	struct CommonTestArgs* common_args = (struct CommonTestArgs*) args;
+
+	for (size_t cycle = 0; cycle < common_args->num_cycles_per_thread; ++cycle)
+	{
+		common_args->number_to_increment += 1;
+	}
+
+	for (unsigned line = 0; line < common_args->num_shared_lines; ++line)
+	{
+		common_args->shared_lines[line].value += 1;
+	}
+}
+
 void* one_thread_job(void* args)
 {
 	struct TestArgs*       thread_args = (struct TestArgs*) args;
 	struct CommonTestArgs* common_args = (struct CommonTestArgs*) thread_args->common;
 
+	// Don't start before every thread is created:
+	SenseBarrier_wait(&common_args->start_barrier, &thread_args->barrier_thread);
+
 	// Measure start time:
 	struct timespec start;
 	if (clock_gettime(CLOCK_MONOTONIC, &start) == -1)
@@ -68,20 +241,62 @@ void* one_thread_job(void* args)
 		exit(EXIT_FAILURE);
 	}
 
-	for (size_t acqisition = 0; acqisition < common_args->num_lock_acuisitions; ++acqisition)
+	size_t acqisition = 0;
+	for (; !acquisitions_done(common_args, acqisition); ++acqisition)
 	{
-		common_args->acquire_lock();
+		think(common_args);
+
+		if (is_read_acquisition(acqisition, common_args->read_percent))
+		{
+			lock_read_acquire(common_args->lock);
+
+			// Shared critical section, no writer may change the variable:
+			volatile unsigned long* to_read = &common_args->number_to_increment;
+			unsigned long observed = *to_read;
+
+			for (size_t cycle = 0; cycle < common_args->num_cycles_per_thread; ++cycle)
+			{
+				if (*to_read != observed)
+				{
+					__atomic_add_fetch(&common_args->num_torn_reads, 1, __ATOMIC_RELAXED);
+					break;
+				}
+			}
+
+			lock_read_release(common_args->lock);
+			continue;
+		}
+
+		if (common_args->delegate)
+		{
+			lock_execute(common_args->lock, critical_section, common_args);
+			continue;
+		}
+
+		if (common_args->measure_latency)
+		{
+			uint64_t acquire_start = monotonic_raw_ns();
+
+			lock_acquire(common_args->lock);
+
+			histogram_record(&thread_args->latency, monotonic_raw_ns() - acquire_start);
+		}
+		else if (!common_args->timed)
+		{
+			lock_acquire(common_args->lock);
+		}
+		else if (!lock_acquire_for(common_args->lock, common_args->timeout_ns))
+		{
+			__atomic_add_fetch(&common_args->num_timeouts, 1, __ATOMIC_RELAXED);
+			continue;
+		}
 		/*
 		Hard to say without actual code, but the naming suggests using lock of some kind, most likely to guarantee exclusive access to a resource / memory.
 		*/
 
-		// Critical section:
-		for (size_t cycle = 0; cycle < common_args->num_cycles_per_thread; ++cycle)
-		{
-			common_args->number_to_increment += 1;
-		}
+		critical_section(common_args);
 
-		common_args->release_lock();
+		lock_release(common_args->lock);
 	}
 
 	// Measure finish time:
@@ -99,26 +314,65 @@ void* one_thread_job(void* args)
 	if (thread_args->thread_execution_time < new_thread_execution_time)
 		thread_args->thread_execution_time = new_thread_execution_time;
 
+	thread_args->num_acquisitions = acqisition;
+
 	return NULL;
 }
 
 
-void run_test(void (*acquire_lock)(), void (*release_lock)(),
-              void (*printout_results)(struct CommonTestArgs*, struct TestArgs*, size_t),
-              unsigned num_lock_acuisitions, unsigned num_cycles_per_thread, unsigned num_runs)
+// Instrumented builds only:
+void print_lock_stats()
+{
+	struct LockStats stats;
+	lock_stats_snapshot(&stats);
+
+	double average_handoff = (stats.num_handoffs == 0)? 0.0 : 1.0 * stats.handoff_cycles / stats.num_handoffs;
+
+	printf(WHITE "      spins %llu, sleeps %llu (%llu ns), yields %llu, failed atomics %llu, handoffs %llu (%.0f cycles avg)\n" RESET,
+	       stats.num_spins, stats.num_sleeps, stats.sleep_ns, stats.num_yields,
+	       stats.num_failed_atomics, stats.num_handoffs, average_handoff);
+}
+
+void run_test(const struct CommonTestArgs* test_args,
+              void (*printout_results)(struct CommonTestArgs*, struct TestArgs*, size_t))
 {
-	struct CommonTestArgs common_args = 
+	// Threads share this copy:
+	struct CommonTestArgs common_args = *test_args;
+
+	if (common_args.thread_step == 0)
 	{
-		.acquire_lock          = acquire_lock,
-		.release_lock          = release_lock,
-		.num_lock_acuisitions  = num_lock_acuisitions,
-		.num_cycles_per_thread = num_cycles_per_thread,
-		.num_runs              = num_runs,
-		.number_to_increment   = 0
-	};
+		default_thread_sweep(&common_args.min_threads, &common_args.max_threads, &common_args.thread_step);
+	}
+
+	// Delegation locks have no acquire/release:
+	if (common_args.lock->ops->execute != NULL) common_args.delegate = 1;
+
+	// CPUs to pin the threads to:
+	int placement_cpus[TOPOLOGY_MAX_CPUS];
+	unsigned num_placement_cpus = 0;
+
+	if (common_args.placement != PLACEMENT_NONE)
+	{
+		num_placement_cpus = topology_placement_order(common_args.placement, placement_cpus);
+	}
+
+	// Keep off the CPU of a delegation server, unless it's the only one:
+	int reserved_cpu = lock_reserved_cpu(common_args.lock);
+
+	if (reserved_cpu >= 0 && num_placement_cpus > 1)
+	{
+		unsigned num_kept = 0;
+
+		for (unsigned cpu_i = 0; cpu_i < num_placement_cpus; ++cpu_i)
+		{
+			if (placement_cpus[cpu_i] != reserved_cpu) placement_cpus[num_kept++] = placement_cpus[cpu_i];
+		}
+
+		num_placement_cpus = num_kept;
+	}
 
 	// Allocate memory for benchmark arguments:
-	struct TestArgs* arg_array = (struct TestArgs*) malloc(MAX_THREADS * sizeof(struct TestArgs));
+	struct TestArgs* arg_array = (struct TestArgs*) malloc(common_args.max_threads * sizeof(struct TestArgs));
 	if (arg_array == NULL)
 	{
 		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
@@ -126,7 +380,7 @@ void run_test(void (*acquire_lock)(), void (*release_lock)(),
 	}
 
 	// Fill in the argument array:
-	for (size_t thread_i = 0; thread_i < MAX_THREADS; ++thread_i)
+	for (size_t thread_i = 0; thread_i < common_args.max_threads; ++thread_i)
 	{
 		arg_array[thread_i].common = &common_args;
 		arg_array[thread_i].thread_execution_time = 0.0;
@@ -140,17 +394,48 @@ void run_test(void (*acquire_lock)(), void (*release_lock)(),
 		exit(EXIT_FAILURE);
 	}
 
-	for (size_t num_threads = THREAD_STEP; num_threads < MAX_THREADS; num_threads += THREAD_STEP)
+	for (size_t num_threads = common_args.min_threads; num_threads <= common_args.max_threads; num_threads += common_args.thread_step)
 	{
-		for (size_t run = 0; run < num_runs; ++run)
+		// Latencies are accumulated over all runs:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			histogram_reset(&arg_array[thread_i].latency);
+
+			barrier_thread_init(&arg_array[thread_i].barrier_thread, thread_i);
+		}
+
+		lock_stats_reset();
+
+		// Workers and this thread:
+		struct BarrierThread barrier_thread;
+		barrier_thread_init(&barrier_thread, num_threads);
+		SenseBarrier_init(&common_args.start_barrier, num_threads + 1, 0);
+
+		for (size_t run = 0; run < common_args.num_runs; ++run)
 		{
 			// Update common_args:
 			common_args.number_to_increment = 0;
+			common_args.num_torn_reads      = 0;
+			common_args.num_timeouts        = 0;
+			common_args.stop                = 0;
 
 			// Spawn threads:
 			for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
 			{
 				arg_array[thread_i].thread_execution_time = 0.0;
+
+				if (num_placement_cpus != 0)
+				{
+					cpu_set_t cpu_set;
+					CPU_ZERO(&cpu_set);
+					CPU_SET(placement_cpus[thread_i % num_placement_cpus], &cpu_set);
+
+					if (pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set), &cpu_set) != 0)
+					{
+						fprintf(stderr, MAGENTA "[Error] Unable to set thread affinity\n" RESET);
+						exit(EXIT_FAILURE);
+					}
+				}
 				
 				if (pthread_create(&arg_array[thread_i].thread_id, &thread_attr, one_thread_job, &arg_array[thread_i]) != 0)
 				{
@@ -159,6 +444,23 @@ void run_test(void (*acquire_lock)(), void (*release_lock)(),
 				}
 			}
 
+			// Start the threads together:
+			SenseBarrier_wait(&common_args.start_barrier, &barrier_thread);
+
+			// Let them run for the given time:
+			if (common_args.duration_seconds != 0.0)
+			{
+				struct timespec duration =
+				{
+					.tv_sec  = (time_t) common_args.duration_seconds,
+					.tv_nsec = (long) ((common_args.duration_seconds - (time_t) common_args.duration_seconds) * 1e9)
+				};
+
+				while (nanosleep(&duration, &duration) == -1);
+
+				__atomic_store_n(&common_args.stop, 1, __ATOMIC_RELAXED);
+			}
+
 			// Join threads:
 			for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
 			{
@@ -172,6 +474,8 @@ void run_test(void (*acquire_lock)(), void (*release_lock)(),
 
 		// Printout test results:
 		printout_results(&common_args, arg_array, num_threads);
+
+		if (lock_stats_enabled()) print_lock_stats();
 	}
 
 	free(arg_array);
@@ -183,8 +487,10 @@ void run_test(void (*acquire_lock)(), void (*release_lock)(),
 
 void correctness_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
 {
-	if (common_args->number_to_increment == num_threads *
-			common_args->num_lock_acuisitions * common_args->num_cycles_per_thread)
+	size_t num_writes = num_write_acquisitions(common_args->num_lock_acuisitions, common_args->read_percent);
+
+	if (common_args->number_to_increment == num_threads * num_writes * common_args->num_cycles_per_thread &&
+	    common_args->num_torn_reads == 0)
 	{
 		printf(YELLOW "The result for %4zu threads is " GREEN "CORRECT\n" RESET, num_threads);
 	}
@@ -194,12 +500,17 @@ void correctness_test_printout(struct CommonTestArgs* common_args, struct TestAr
 	}
 }
 
-void run_correctness_test(void (*acquire_lock)(), void (*release_lock)())
+void run_correctness_test(struct Lock* lock)
 {
-	run_test(acquire_lock, release_lock, correctness_test_printout, 
-	         CORRECTNESS_TEST_NUM_LOCK_ACQISITIONS,
-	         CORRECTNESS_TEST_NUMBER_OF_CYCLES,
-	         CORRECTNESS_TEST_NUM_REPEATS);
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.num_lock_acuisitions  = CORRECTNESS_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = CORRECTNESS_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = CORRECTNESS_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, correctness_test_printout);
 }
 
 //---------------------------
@@ -222,12 +533,18 @@ void performance_test_printout(struct CommonTestArgs* common_args, struct TestAr
 	printf(YELLOW "%4zu, %10f\n" RESET, num_threads, average_time);
 }
 
-void run_performance_test(void (*acquire_lock)(), void (*release_lock)())
+void run_performance_test(struct Lock* lock, enum TopologyPlacement placement)
 {
-	run_test(acquire_lock, release_lock, performance_test_printout, 
-	         PERFORMANCE_TEST_NUM_LOCK_ACQISITIONS,
-	         PERFORMANCE_TEST_NUMBER_OF_CYCLES,
-	         PERFORMANCE_TEST_NUM_REPEATS);
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.placement             = placement,
+		.num_lock_acuisitions  = PERFORMANCE_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = PERFORMANCE_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = PERFORMANCE_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, performance_test_printout);
 }
 
 //------------------------
@@ -236,25 +553,974 @@ void run_performance_test(void (*acquire_lock)(), void (*release_lock)())
 
 void fairness_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
 {
-	// Calculate maximum thread execution time:
+	// Merge per-thread histograms:
+	static struct LatencyHistogram merged;
+	histogram_reset(&merged);
+
+	// Jain's fairness index over per-thread mean latencies:
+	// (sum x)^2 / (n * sum x^2) is 1 if every thread waits equally long
+	// and 1/n if a single thread does all the waiting.
+	double sum_means    = 0.0;
+	double sum_means_sq = 0.0;
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		const struct LatencyHistogram* latency = &arg_array[thread_i].latency;
+
+		histogram_merge(&merged, latency);
+
+		double mean = (latency->num_values == 0)? 0.0 : 1.0 * latency->sum / latency->num_values;
+
+		sum_means    += mean;
+		sum_means_sq += mean * mean;
+	}
+
+	double jain_index = (sum_means_sq == 0.0)? 1.0 : sum_means * sum_means / (num_threads * sum_means_sq);
+
+	// Printout the result (nanoseconds):
+	printf(YELLOW "%4zu, %10llu, %10llu, %10llu, %10llu, %6.4f\n" RESET, num_threads,
+	       (unsigned long long) histogram_percentile(&merged, 50.0),
+	       (unsigned long long) histogram_percentile(&merged, 99.0),
+	       (unsigned long long) histogram_percentile(&merged, 99.9),
+	       (unsigned long long) merged.max, jain_index);
+}
+
+void run_fairness_test(struct Lock* lock)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.measure_latency       = 1,
+		.num_lock_acuisitions  = FAIRNESS_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = FAIRNESS_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = FAIRNESS_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, fairness_test_printout);
+}
+
+//--------------------------------------
+// Benchmark #4: Read-write scalability 
+//--------------------------------------
+
+void run_rw_correctness_test(struct Lock* lock, unsigned read_percent)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.read_percent          = read_percent,
+		.num_lock_acuisitions  = CORRECTNESS_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = CORRECTNESS_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = CORRECTNESS_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, correctness_test_printout);
+}
+
+void run_rw_performance_test(struct Lock* lock, unsigned read_percent)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.read_percent          = read_percent,
+		.num_lock_acuisitions  = PERFORMANCE_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = PERFORMANCE_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = PERFORMANCE_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, performance_test_printout);
+}
+
+//---------------------------------
+// Benchmark #5: Oversubscription 
+//---------------------------------
+
+void oversubscription_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	// Calculate average and maximum thread execution time:
+	double average_time = 0.0;
+	double max_time     = 0.0;
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		average_time += arg_array[thread_i].thread_execution_time;
+
+		if (max_time < arg_array[thread_i].thread_execution_time)
+		{
+			max_time = arg_array[thread_i].thread_execution_time;
+		}
+	}
+
+	average_time /= num_threads;
+
+	// Printout the result:
+	printf(YELLOW "%4zu (x%zu), %10f, %10f\n" RESET, num_threads, num_threads / common_args->min_threads, average_time, max_time);
+}
+
+void run_oversubscription_test(struct Lock* lock)
+{
+	const size_t num_cpus = topology_num_cpus();
+
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.num_lock_acuisitions  = OVERSUBSCRIPTION_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = OVERSUBSCRIPTION_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = OVERSUBSCRIPTION_TEST_NUM_REPEATS,
+		.min_threads           = num_cpus,
+		.max_threads           = num_cpus * OVERSUBSCRIPTION_TEST_MAX_FACTOR,
+		.thread_step           = num_cpus
+	};
+
+	run_test(&common_args, oversubscription_test_printout);
+}
+
+//---------------------------------
+// Benchmark #7: Timed acquisition 
+//---------------------------------
+
+void timed_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	size_t num_attempts  = num_threads * common_args->num_lock_acuisitions;
+	size_t num_successes = num_attempts - common_args->num_timeouts;
+
+	// Calculate average time of one attempt:
+	double average_time = 0.0;
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		average_time += arg_array[thread_i].thread_execution_time;
+	}
+
+	average_time /= num_attempts;
+
+	// Every successful acquisition must be exclusive:
+	const char* verdict = (common_args->number_to_increment == num_successes * common_args->num_cycles_per_thread)?
+	                      GREEN "CORRECT" : RED "WRONG";
+
+	// Printout the result:
+	printf(YELLOW "%4zu, %6.2f%%, %10f, %s\n" RESET, num_threads, 100.0 * num_successes / num_attempts, average_time, verdict);
+}
+
+void run_timed_test(struct Lock* lock, unsigned long long timeout_ns)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.timed                 = 1,
+		.timeout_ns            = timeout_ns,
+		.num_lock_acuisitions  = TIMED_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = TIMED_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = TIMED_TEST_NUM_REPEATS
+	};
+
+	run_test(&common_args, timed_test_printout);
+}
+
+//--------------------------
+// Benchmark #8: Throughput 
+//--------------------------
+
+void throughput_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	// Total acquisitions over the longest thread run time:
+	unsigned long num_acquisitions = 0;
+	double max_time = 0.0;
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		num_acquisitions += arg_array[thread_i].num_acquisitions;
+
+		if (max_time < arg_array[thread_i].thread_execution_time)
+		{
+			max_time = arg_array[thread_i].thread_execution_time;
+		}
+	}
+
+	// Every acquisition must be exclusive:
+	const char* verdict = (common_args->number_to_increment == num_acquisitions * common_args->num_cycles_per_thread)?
+	                      GREEN "CORRECT" : RED "WRONG";
+
+	// Printout the result:
+	printf(YELLOW "%4zu, %12.0f, %s\n" RESET, num_threads, num_acquisitions / max_time, verdict);
+}
+
+void run_throughput_test(struct Lock* lock, enum TopologyPlacement placement)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.placement             = placement,
+		.duration_seconds      = THROUGHPUT_TEST_DURATION_SECONDS,
+		.num_cycles_per_thread = THROUGHPUT_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = 1
+	};
+
+	run_test(&common_args, throughput_test_printout);
+}
+
+//------------------------
+// Benchmark #9: Workload 
+//------------------------
+
+void workload_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	unsigned long num_acquisitions = 0;
 	double max_time = 0.0;
 
 	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
 	{
+		num_acquisitions += arg_array[thread_i].num_acquisitions;
+
 		if (max_time < arg_array[thread_i].thread_execution_time)
 		{
 			max_time = arg_array[thread_i].thread_execution_time;
 		}
 	}
 
+	// Every shared line is incremented once per acquisition:
+	int correct = 1;
+
+	for (unsigned line = 0; line < common_args->num_shared_lines; ++line)
+	{
+		if (common_args->shared_lines[line].value != num_acquisitions) correct = 0;
+
+		common_args->shared_lines[line].value = 0;
+	}
+
+	const char* verdict = correct? GREEN "CORRECT" : RED "WRONG";
+
 	// Printout the result:
-	printf(YELLOW "%4zu, %10f\n" RESET, num_threads, max_time);
+	printf(YELLOW "%4zu, %12.0f, %s\n" RESET, num_threads, num_acquisitions / max_time, verdict);
 }
 
-void run_fairness_test(void (*acquire_lock)(), void (*release_lock)())
+void run_workload_test(struct Lock* lock, struct Workload workload)
 {
-	run_test(acquire_lock, release_lock, fairness_test_printout, 
-	         FAIRNESS_TEST_NUM_LOCK_ACQISITIONS,
-	         FAIRNESS_TEST_NUMBER_OF_CYCLES,
-	         FAIRNESS_TEST_NUM_REPEATS);
+	// One spare line, so a workload without shared lines is still a valid allocation:
+	struct SharedLine* shared_lines = (struct SharedLine*) aligned_alloc(_Alignof(struct SharedLine),
+	                                                                    (workload.num_cache_lines + 1) * sizeof(struct SharedLine));
+	if (shared_lines == NULL)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	for (unsigned line = 0; line < workload.num_cache_lines; ++line)
+	{
+		shared_lines[line].value = 0;
+	}
+
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.shared_lines          = shared_lines,
+		.num_shared_lines      = workload.num_cache_lines,
+		.mean_think_ns         = workload.mean_think_ns,
+		.duration_seconds      = WORKLOAD_TEST_DURATION_SECONDS,
+		.num_cycles_per_thread = WORKLOAD_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = 1
+	};
+
+	run_test(&common_args, workload_test_printout);
+
+	free(shared_lines);
+}
+
+//------------------------------------
+// Benchmark #10: Sequence lock reads 
+//------------------------------------
+
+// Several words, so a copy racing with a writer would be torn:
+#define SEQLOCK_TEST_NUM_WORDS 8
+
+struct SeqLockTestData
+{
+	unsigned long words[SEQLOCK_TEST_NUM_WORDS];
+};
+
+struct SeqLockTestCommon
+{
+	struct SeqLock lock;
+
+	struct SeqLockTestData data;
+
+	unsigned read_percent;
+
+	struct SenseBarrier start_barrier;
+};
+
+struct SeqLockTestArgs
+{
+	struct SeqLockTestCommon* common;
+
+	pthread_t thread_id;
+
+	// In nanoseconds:
+	double thread_execution_time;
+	unsigned long num_torn_reads;
+
+	struct BarrierThread barrier_thread;
+};
+
+void* seqlock_thread_job(void* args)
+{
+	struct SeqLockTestArgs*   thread_args = (struct SeqLockTestArgs*) args;
+	struct SeqLockTestCommon* common      = thread_args->common;
+
+	SenseBarrier_wait(&common->start_barrier, &thread_args->barrier_thread);
+
+	uint64_t start = monotonic_raw_ns();
+
+	struct SeqLockTestData copy;
+
+	for (long access = 0; access < SEQLOCK_TEST_NUM_ACCESSES; ++access)
+	{
+		if (is_read_acquisition(access, common->read_percent))
+		{
+			SEQLOCK_READ(&common->lock, &copy, &common->data);
+
+			// A consistent copy has all words equal:
+			for (unsigned word = 1; word < SEQLOCK_TEST_NUM_WORDS; ++word)
+			{
+				if (copy.words[word] != copy.words[0])
+				{
+					thread_args->num_torn_reads += 1;
+					break;
+				}
+			}
+		}
+		else
+		{
+			SeqLock_write_acquire(&common->lock);
+
+			unsigned long value = common->data.words[0] + 1;
+
+			for (unsigned word = 0; word < SEQLOCK_TEST_NUM_WORDS; ++word)
+			{
+				__atomic_store_n(&common->data.words[word], value, __ATOMIC_RELAXED);
+			}
+
+			SeqLock_write_release(&common->lock);
+		}
+	}
+
+	thread_args->thread_execution_time = monotonic_raw_ns() - start;
+
+	return NULL;
+}
+
+void run_seqlock_test(unsigned read_percent)
+{
+	size_t min_threads, max_threads, thread_step;
+	default_thread_sweep(&min_threads, &max_threads, &thread_step);
+
+	struct SeqLockTestArgs* arg_array = (struct SeqLockTestArgs*) malloc(max_threads * sizeof(struct SeqLockTestArgs));
+	if (arg_array == NULL)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	struct SeqLockTestCommon common = {.read_percent = read_percent};
+
+	for (size_t num_threads = min_threads; num_threads <= max_threads; num_threads += thread_step)
+	{
+		SeqLock_init(&common.lock);
+
+		for (unsigned word = 0; word < SEQLOCK_TEST_NUM_WORDS; ++word)
+		{
+			common.data.words[word] = 0;
+		}
+
+		lock_stats_reset();
+
+		// Workers and this thread:
+		struct BarrierThread barrier_thread;
+		barrier_thread_init(&barrier_thread, num_threads);
+		SenseBarrier_init(&common.start_barrier, num_threads + 1, 0);
+
+		// Spawn threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			arg_array[thread_i].common                = &common;
+			arg_array[thread_i].thread_execution_time = 0.0;
+			arg_array[thread_i].num_torn_reads        = 0;
+			barrier_thread_init(&arg_array[thread_i].barrier_thread, thread_i);
+
+			if (pthread_create(&arg_array[thread_i].thread_id, NULL, seqlock_thread_job, &arg_array[thread_i]) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to create thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		// Start the threads together:
+		SenseBarrier_wait(&common.start_barrier, &barrier_thread);
+
+		// Join threads:
+		double average_time = 0.0;
+		unsigned long num_torn_reads = 0;
+
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			if (pthread_join(arg_array[thread_i].thread_id, NULL) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to join thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+
+			average_time   += arg_array[thread_i].thread_execution_time;
+			num_torn_reads += arg_array[thread_i].num_torn_reads;
+		}
+
+		average_time /= num_threads * SEQLOCK_TEST_NUM_ACCESSES;
+
+		// No torn copies, and every write applied exactly once:
+		size_t num_writes = num_threads * num_write_acquisitions(SEQLOCK_TEST_NUM_ACCESSES, read_percent);
+
+		const char* verdict = (num_torn_reads == 0 && common.data.words[SEQLOCK_TEST_NUM_WORDS - 1] == num_writes)?
+		                      GREEN "CORRECT" : RED "WRONG";
+
+		// Printout the result:
+		printf(YELLOW "%4zu, %10.1f, %s\n" RESET, num_threads, average_time, verdict);
+
+		if (lock_stats_enabled()) print_lock_stats();
+	}
+
+	free(arg_array);
+}
+
+//-------------------------------------
+// Benchmark #11: Delegation throughput 
+//-------------------------------------
+
+void run_delegation_test(struct Lock* lock)
+{
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.delegate              = 1,
+		.duration_seconds      = DELEGATION_TEST_DURATION_SECONDS,
+		.num_cycles_per_thread = DELEGATION_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = 1,
+		.min_threads           = DELEGATION_TEST_MIN_THREADS,
+		.max_threads           = DELEGATION_TEST_MAX_THREADS,
+		.thread_step           = DELEGATION_TEST_THREAD_STEP
+	};
+
+	run_test(&common_args, throughput_test_printout);
+}
+
+//---------------------------------
+// Benchmark #12: Barrier crossing 
+//---------------------------------
+
+struct BarrierTestArgs
+{
+	struct Barrier* barrier;
+
+	// Crossings completed by every thread:
+	volatile long* phases;
+	size_t num_threads;
+
+	pthread_t thread_id;
+	struct BarrierThread barrier_thread;
+
+	// In nanoseconds:
+	double thread_execution_time;
+	unsigned long num_early_crossings;
+};
+
+void* barrier_thread_job(void* args)
+{
+	struct BarrierTestArgs* thread_args = (struct BarrierTestArgs*) args;
+
+	const unsigned thread_id = thread_args->barrier_thread.thread_id;
+	volatile long* neighbour_phase = &thread_args->phases[(thread_id + 1) % thread_args->num_threads];
+
+	// The first crossing lines the threads up and is not timed:
+	barrier_wait(thread_args->barrier, &thread_args->barrier_thread);
+
+	uint64_t start = monotonic_raw_ns();
+
+	for (long crossing = 0; crossing < BARRIER_TEST_NUM_CROSSINGS; ++crossing)
+	{
+		__atomic_store_n(&thread_args->phases[thread_id], crossing, __ATOMIC_RELAXED);
+
+		barrier_wait(thread_args->barrier, &thread_args->barrier_thread);
+
+		// Nobody leaves the barrier before everybody has arrived:
+		if (__atomic_load_n(neighbour_phase, __ATOMIC_RELAXED) < crossing)
+		{
+			thread_args->num_early_crossings += 1;
+		}
+	}
+
+	thread_args->thread_execution_time = monotonic_raw_ns() - start;
+
+	return NULL;
+}
+
+void run_barrier_test(const struct BarrierOps* ops, int futex_fallback)
+{
+	size_t min_threads, max_threads, thread_step;
+	default_thread_sweep(&min_threads, &max_threads, &thread_step);
+
+	struct BarrierTestArgs* arg_array = (struct BarrierTestArgs*) malloc(max_threads * sizeof(struct BarrierTestArgs));
+	volatile long*          phases    = (volatile long*) malloc(max_threads * sizeof(long));
+	if (arg_array == NULL || phases == NULL)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	for (size_t num_threads = min_threads; num_threads <= max_threads; num_threads += thread_step)
+	{
+		struct Barrier barrier;
+		if (barrier_create(&barrier, ops, num_threads, futex_fallback) != 0)
+		{
+			fprintf(stderr, MAGENTA "[Error] Unable to init %s\n" RESET, ops->name);
+			exit(EXIT_FAILURE);
+		}
+
+		// Spawn threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			phases[thread_i] = -1;
+
+			arg_array[thread_i].barrier               = &barrier;
+			arg_array[thread_i].phases                = phases;
+			arg_array[thread_i].num_threads           = num_threads;
+			arg_array[thread_i].thread_execution_time = 0.0;
+			arg_array[thread_i].num_early_crossings   = 0;
+
+			barrier_thread_init(&arg_array[thread_i].barrier_thread, thread_i);
+		}
+
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			if (pthread_create(&arg_array[thread_i].thread_id, NULL, barrier_thread_job, &arg_array[thread_i]) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to create thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		// Join threads:
+		double average_time = 0.0;
+		unsigned long num_early_crossings = 0;
+
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			if (pthread_join(arg_array[thread_i].thread_id, NULL) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to join thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+
+			average_time        += arg_array[thread_i].thread_execution_time;
+			num_early_crossings += arg_array[thread_i].num_early_crossings;
+		}
+
+		average_time /= num_threads * BARRIER_TEST_NUM_CROSSINGS;
+
+		barrier_destroy(&barrier);
+
+		const char* verdict = (num_early_crossings == 0)? GREEN "CORRECT" : RED "WRONG";
+
+		// Printout the result:
+		printf(YELLOW "%4zu, %10.1f, %s\n" RESET, num_threads, average_time, verdict);
+	}
+
+	free((void*) phases);
+	free(arg_array);
+}
+
+//--------------------------------------------
+// Benchmark #13: Oversubscribed tail latency 
+//--------------------------------------------
+
+void oversubscribed_latency_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	// Merge per-thread histograms:
+	static struct LatencyHistogram merged;
+	histogram_reset(&merged);
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		histogram_merge(&merged, &arg_array[thread_i].latency);
+	}
+
+	// A skipped waiter still has to get the lock eventually:
+	if (common_args->number_to_increment != num_threads * common_args->num_lock_acuisitions * common_args->num_cycles_per_thread)
+	{
+		printf(YELLOW "The result for %4zu threads is " RED "WRONG\n" RESET, num_threads);
+		return;
+	}
+
+	// Printout the result (nanoseconds):
+	printf(YELLOW "%4zu (x%zu), %10llu, %10llu, %10llu, %10llu\n" RESET, num_threads,
+	       num_threads / topology_num_cpus(),
+	       (unsigned long long) histogram_percentile(&merged, 50.0),
+	       (unsigned long long) histogram_percentile(&merged, 99.0),
+	       (unsigned long long) histogram_percentile(&merged, 99.9),
+	       (unsigned long long) merged.max);
+}
+
+void run_oversubscribed_latency_test(struct Lock* lock)
+{
+	const size_t num_cpus = topology_num_cpus();
+
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.measure_latency       = 1,
+		.num_lock_acuisitions  = OVERSUBSCRIBED_LATENCY_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = OVERSUBSCRIBED_LATENCY_TEST_NUMBER_OF_CYCLES,
+		.num_runs              = OVERSUBSCRIBED_LATENCY_TEST_NUM_REPEATS,
+		.min_threads           = num_cpus * OVERSUBSCRIBED_LATENCY_TEST_MIN_FACTOR,
+		.max_threads           = num_cpus * OVERSUBSCRIBED_LATENCY_TEST_MAX_FACTOR,
+		.thread_step           = num_cpus * OVERSUBSCRIBED_LATENCY_TEST_MIN_FACTOR
+	};
+
+	run_test(&common_args, oversubscribed_latency_test_printout);
+}
+
+//-------------------------------------
+// Benchmark #14: Skewed lock ownership 
+//-------------------------------------
+
+struct SkewedTestCommon
+{
+	struct Lock lock;
+
+	unsigned long number_to_increment;
+
+	struct SenseBarrier start_barrier;
+};
+
+struct SkewedTestArgs
+{
+	struct SkewedTestCommon* common;
+
+	pthread_t thread_id;
+
+	// Thread 0 is the dominant owner, it takes the lock first:
+	size_t thread_i;
+	unsigned long num_acquisitions;
+
+	struct BarrierThread barrier_thread;
+};
+
+void* skewed_thread_job(void* args)
+{
+	struct SkewedTestArgs*   thread_args = (struct SkewedTestArgs*) args;
+	struct SkewedTestCommon* common      = thread_args->common;
+
+	// The others are still at the barrier, so a biased lock is biased to us:
+	if (thread_args->thread_i == 0 && thread_args->num_acquisitions != 0)
+	{
+		lock_acquire(&common->lock);
+
+		common->number_to_increment += 1;
+
+		lock_release(&common->lock);
+
+		thread_args->num_acquisitions -= 1;
+	}
+
+	SenseBarrier_wait(&common->start_barrier, &thread_args->barrier_thread);
+
+	for (unsigned long acquisition = 0; acquisition < thread_args->num_acquisitions; ++acquisition)
+	{
+		lock_acquire(&common->lock);
+
+		common->number_to_increment += 1;
+
+		lock_release(&common->lock);
+	}
+
+	return NULL;
+}
+
+void run_skewed_test(const struct LockOps* ops, unsigned owner_percent)
+{
+	size_t min_threads, max_threads, thread_step;
+	default_thread_sweep(&min_threads, &max_threads, &thread_step);
+
+	struct SkewedTestArgs* arg_array = (struct SkewedTestArgs*) malloc(max_threads * sizeof(struct SkewedTestArgs));
+	if (arg_array == NULL)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	struct SkewedTestCommon common;
+
+	for (size_t num_threads = min_threads; num_threads <= max_threads; num_threads += thread_step)
+	{
+		// A fresh lock, so the bias goes to thread 0:
+		if (lock_create(&common.lock, ops) != 0)
+		{
+			fprintf(stderr, MAGENTA "[Error] Unable to init %s\n" RESET, ops->name);
+			exit(EXIT_FAILURE);
+		}
+
+		common.number_to_increment = 0;
+
+		// The owner does owner_percent of the acquisitions, the rest is split evenly:
+		unsigned long num_owner_acquisitions = (num_threads == 1)? SKEWED_TEST_NUM_ACQUISITIONS :
+		                                       SKEWED_TEST_NUM_ACQUISITIONS * owner_percent / 100;
+		unsigned long num_other_acquisitions = (num_threads == 1)? 0 :
+		                                       (SKEWED_TEST_NUM_ACQUISITIONS - num_owner_acquisitions) / (num_threads - 1);
+
+		unsigned long num_acquisitions = num_owner_acquisitions + num_other_acquisitions * (num_threads - 1);
+
+		lock_stats_reset();
+
+		// Workers and this thread:
+		struct BarrierThread barrier_thread;
+		barrier_thread_init(&barrier_thread, num_threads);
+		SenseBarrier_init(&common.start_barrier, num_threads + 1, 0);
+
+		// Spawn threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			arg_array[thread_i].common           = &common;
+			arg_array[thread_i].thread_i         = thread_i;
+			arg_array[thread_i].num_acquisitions = (thread_i == 0)? num_owner_acquisitions : num_other_acquisitions;
+			barrier_thread_init(&arg_array[thread_i].barrier_thread, thread_i);
+
+			if (pthread_create(&arg_array[thread_i].thread_id, NULL, skewed_thread_job, &arg_array[thread_i]) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to create thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		// No acquisition starts before this thread arrives at the barrier:
+		uint64_t start = monotonic_raw_ns();
+
+		// Start the threads together:
+		SenseBarrier_wait(&common.start_barrier, &barrier_thread);
+
+		// Join threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			if (pthread_join(arg_array[thread_i].thread_id, NULL) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to join thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		double average_time = 1.0 * (monotonic_raw_ns() - start) / num_acquisitions;
+
+		const char* verdict = (common.number_to_increment == num_acquisitions)? GREEN "CORRECT" : RED "WRONG";
+
+		// Printout the result:
+		printf(YELLOW "%4zu, %10.1f, %s\n" RESET, num_threads, average_time, verdict);
+
+		if (lock_stats_enabled()) print_lock_stats();
+
+		lock_destroy(&common.lock);
+	}
+
+	free(arg_array);
+}
+
+//----------------------------------------------
+// Benchmark #15: Critical section length sweep 
+//----------------------------------------------
+
+void cs_sweep_test_printout(struct CommonTestArgs* common_args, struct TestArgs* arg_array, size_t num_threads)
+{
+	// Calculate average thread execution time:
+	double average_time = 0.0;
+
+	for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		average_time += arg_array[thread_i].thread_execution_time;
+	}
+
+	average_time /= num_threads;
+
+	// Printout the result:
+	printf(YELLOW "%4zu, %8u, %10f\n" RESET, num_threads, common_args->num_cycles_per_thread, average_time);
+}
+
+void run_cs_sweep_test(struct Lock* lock, unsigned num_cycles_per_thread)
+{
+	size_t min_threads, max_threads, thread_step;
+	default_thread_sweep(&min_threads, &max_threads, &thread_step);
+
+	// The most contended point of the sweep only:
+	struct CommonTestArgs common_args =
+	{
+		.lock                  = lock,
+		.num_lock_acuisitions  = CS_SWEEP_TEST_NUM_LOCK_ACQISITIONS,
+		.num_cycles_per_thread = num_cycles_per_thread,
+		.num_runs              = CS_SWEEP_TEST_NUM_REPEATS,
+		.min_threads           = max_threads,
+		.max_threads           = max_threads,
+		.thread_step           = max_threads
+	};
+
+	run_test(&common_args, cs_sweep_test_printout);
+}
+
+//-----------------------------------------------
+// Benchmark #16: Adjacent locks (false sharing) 
+//-----------------------------------------------
+
+struct AdjacentTestCommon
+{
+	struct Lock locks[ADJACENT_TEST_NUM_LOCKS];
+
+	// A counter per lock, on lines of their own, so only the locks may share lines:
+	struct SharedLine counters[ADJACENT_TEST_NUM_LOCKS];
+
+	struct SenseBarrier start_barrier;
+};
+
+struct AdjacentTestArgs
+{
+	struct AdjacentTestCommon* common;
+
+	pthread_t thread_id;
+
+	// Thread i takes lock i % ADJACENT_TEST_NUM_LOCKS only:
+	size_t thread_i;
+
+	double thread_execution_time;
+
+	struct BarrierThread barrier_thread;
+};
+
+// Critical section of one group:
+void adjacent_critical_section(void* args)
+{
+	struct SharedLine* counter = (struct SharedLine*) args;
+
+	for (long cycle = 0; cycle < ADJACENT_TEST_NUMBER_OF_CYCLES; ++cycle)
+	{
+		counter->value += 1;
+	}
+}
+
+void* adjacent_thread_job(void* args)
+{
+	struct AdjacentTestArgs*   thread_args = (struct AdjacentTestArgs*) args;
+	struct AdjacentTestCommon* common      = thread_args->common;
+
+	size_t group = thread_args->thread_i % ADJACENT_TEST_NUM_LOCKS;
+
+	SenseBarrier_wait(&common->start_barrier, &thread_args->barrier_thread);
+
+	uint64_t start = monotonic_raw_ns();
+
+	for (long acquisition = 0; acquisition < ADJACENT_TEST_NUM_LOCK_ACQISITIONS; ++acquisition)
+	{
+		lock_execute(&common->locks[group], adjacent_critical_section, &common->counters[group]);
+	}
+
+	thread_args->thread_execution_time = 1e-9 * (monotonic_raw_ns() - start);
+
+	return NULL;
+}
+
+void run_adjacent_locks_test(const struct LockOps* ops)
+{
+	size_t min_threads, max_threads, thread_step;
+	default_thread_sweep(&min_threads, &max_threads, &thread_step);
+
+	// Every group gets the same number of threads:
+	max_threads = (max_threads + ADJACENT_TEST_NUM_LOCKS - 1) / ADJACENT_TEST_NUM_LOCKS * ADJACENT_TEST_NUM_LOCKS;
+
+	struct AdjacentTestArgs* arg_array = (struct AdjacentTestArgs*) malloc(max_threads * sizeof(struct AdjacentTestArgs));
+	if (arg_array == NULL)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to get allocate memory\n" RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	struct AdjacentTestCommon common;
+
+	if (lock_create_array(common.locks, ADJACENT_TEST_NUM_LOCKS, ops) != 0)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to init %s\n" RESET, ops->name);
+		exit(EXIT_FAILURE);
+	}
+
+	for (size_t num_threads = ADJACENT_TEST_NUM_LOCKS; num_threads <= max_threads; num_threads += ADJACENT_TEST_NUM_LOCKS)
+	{
+		for (size_t group = 0; group < ADJACENT_TEST_NUM_LOCKS; ++group)
+		{
+			common.counters[group].value = 0;
+		}
+
+		lock_stats_reset();
+
+		// Workers and this thread:
+		struct BarrierThread barrier_thread;
+		barrier_thread_init(&barrier_thread, num_threads);
+		SenseBarrier_init(&common.start_barrier, num_threads + 1, 0);
+
+		// Spawn threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			arg_array[thread_i].common                = &common;
+			arg_array[thread_i].thread_i              = thread_i;
+			arg_array[thread_i].thread_execution_time = 0.0;
+			barrier_thread_init(&arg_array[thread_i].barrier_thread, thread_i);
+
+			if (pthread_create(&arg_array[thread_i].thread_id, NULL, adjacent_thread_job, &arg_array[thread_i]) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to create thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		// Start the threads together:
+		SenseBarrier_wait(&common.start_barrier, &barrier_thread);
+
+		// Join threads:
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			if (pthread_join(arg_array[thread_i].thread_id, NULL) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to join thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		// Calculate average thread execution time:
+		double average_time = 0.0;
+
+		for (size_t thread_i = 0; thread_i < num_threads; ++thread_i)
+		{
+			average_time += arg_array[thread_i].thread_execution_time;
+		}
+
+		average_time /= num_threads;
+
+		// Every group incremented its own counter only:
+		unsigned long expected = num_threads / ADJACENT_TEST_NUM_LOCKS * ADJACENT_TEST_NUM_LOCK_ACQISITIONS * ADJACENT_TEST_NUMBER_OF_CYCLES;
+
+		const char* verdict = GREEN "CORRECT";
+
+		for (size_t group = 0; group < ADJACENT_TEST_NUM_LOCKS; ++group)
+		{
+			if (common.counters[group].value != expected) verdict = RED "WRONG";
+		}
+
+		// Printout the result:
+		printf(YELLOW "%4zu, %10f, %s\n" RESET, num_threads, average_time, verdict);
+
+		if (lock_stats_enabled()) print_lock_stats();
+	}
+
+	lock_destroy_array(common.locks, ADJACENT_TEST_NUM_LOCKS);
+
+	free(arg_array);
 }
@@ -13,12 +13,104 @@
 //-------------------------------------------------------------------
 // Benchmark #3: Fairness
 // P threads perform a handful of lock acuisitions for some job.
-// Each lock acquisition time is measured. Maximum lock acquisition
-// time Tm is computed. Plot Tm(P) is the output.
+// Each lock acquisition time is measured into a per-thread latency
+// histogram. Percentiles p50/p99/p99.9, maximum acquisition time
+// and Jain's fairness index J over per-thread mean acquisition
+// times are the output.
+//-------------------------------------------------------------------
+// Benchmark #4: Read-write scalability
+// P threads perform lock acquisitions, R percent of them are shared
+// reads, which check that no writer changes the variable meanwhile.
+// The rest are exclusive increments. Plot Ta(P) for a given R.
+//-------------------------------------------------------------------
+// Benchmark #5: Oversubscription
+// K*C threads (C - number of CPUs, K = 1..4) perform a handful of
+// lock acquisitions. Average time Ta and maximum time Tm are the
+// output, they show the cost of waiters that hold the CPU.
+//-------------------------------------------------------------------
+// Benchmark #6: Backoff jitter
+// Benchmarks #2 and #8 for the TAS and TTAS locks, run once with
+// rand() and once with fast_random() as the source of the random
+// part of every backoff sleep (spin_backoff_jitter of SpinLocks.h).
+// The two runs show whether the generator serializes the waiters.
+//-------------------------------------------------------------------
+// Benchmark #7: Timed acquisition
+// P threads perform a handful of acquisitions with a timeout T.
+// The share of successful acquisitions and the average time of one
+// attempt are the output.
+//-------------------------------------------------------------------
+// Benchmark #8: Throughput
+// P threads perform lock acquisitions for a fixed time D. Total
+// number of acquisitions per second is the output.
+//-------------------------------------------------------------------
+// Benchmark #9: Workload
+// As #8, but the critical section reads and writes L distinct cache
+// lines and every acquisition follows a random think time T outside
+// the lock. Sweeping T moves the lock from saturated to uncontended.
+//-------------------------------------------------------------------
+// Benchmark #10: Sequence lock reads
+// P threads access a multi-word block guarded by a seqlock, R percent
+// of the accesses are optimistic copies, which check that no word of
+// the copy is torn. The rest are writes of all words. Average time
+// of one access Ta in ns and the torn-read check are the output.
+//-------------------------------------------------------------------
+// Benchmark #11: Delegation throughput
+// As #8 with a one-increment critical section and P = 8..128, but
+// the critical section is handed over to lock_execute(), so delegation
+// locks (flat combining) compete with the usual ones. Total number
+// of critical sections per second is the output.
+//-------------------------------------------------------------------
+// Benchmark #12: Barrier crossing
+// P threads cross a barrier N times in a row, with waiters either
+// yielding or sleeping on a futex. Average crossing latency Ta in ns
+// and a check that no thread left a crossing early are the output.
+//-------------------------------------------------------------------
+// Benchmark #13: Oversubscribed tail latency
+// As #3 with K*C threads (C - number of CPUs, K = 2 and 4), so lock
+// holders and waiters get preempted. Percentiles p50/p99/p99.9 and
+// maximum acquisition time are the output, they show how a queue
+// lock copes with preempted waiters in the middle of the queue.
+//-------------------------------------------------------------------
+// Benchmark #14: Skewed lock ownership
+// P threads perform N acquisitions in total, one thread (the first
+// to take the lock) does S percent of them, the rest share the
+// remainder. Average time of one acquisition Ta in ns (wall clock
+// over all acquisitions) and the correctness check are the output.
+//-------------------------------------------------------------------
+// Benchmark #15: Critical section length sweep
+// As #2 at the largest P of the sweep, with the critical section
+// length L swept over orders of magnitude. Plot Ta(L) for every
+// lock shows whether a self-tuning lock keeps up with the best
+// fixed spin and backoff constants at every L.
+//-------------------------------------------------------------------
+// Benchmark #16: Adjacent locks (false sharing)
+// K locks are laid out back to back, as in an array of the lock type.
+// P threads form K disjoint groups, group g only takes lock g and
+// increments its own counter. Packed locks share a cache line, so
+// the groups slow each other down, padded ones don't. Average time
+// Ta and a check of every group's counter are the output.
+//-------------------------------------------------------------------
+// All threads of a benchmark are released together by a start
+// barrier (SenseBarrier of Barriers.h), so none of them runs
+// uncontended while the rest are still being created.
+//
+// The thread count P sweeps up to the number of online CPUs.
+// Benchmarks #2 and #8 pin threads to CPUs with a placement policy
+// (compact, scatter or cross-socket, see Topology.h).
+//
+// Delegation locks (no acquire/release) run Benchmarks #1, #2 and #11,
+// handing their critical sections over to lock_execute().
+//
+// In the instrumented build (make STATS=1) every result line is
+// followed by the lock counters of LockStats.h.
 //-------------------------------------------------------------------
 #ifndef SPIN_LOCK_BENCHMARKS_HPP_INCLUDED
 #define SPIN_LOCK_BENCHMARKS_HPP_INCLUDED
 
+#include "LockInterface.h"
+#include "Barriers.h"
+#include "Topology.h"
+
 //---------------
 // Miscellaneous 
 //---------------
@@ -37,18 +129,101 @@
 // Benchmark #1: Correctness 
 //---------------------------
 
-void run_correctness_test(void (*acquire_lock)(), void (*release_lock)());
+void run_correctness_test(struct Lock* lock);
 
 //---------------------------
 // Benchmark #2: Performance 
 //---------------------------
 
-void run_performance_test(void (*acquire_lock)(), void (*release_lock)());
+void run_performance_test(struct Lock* lock, enum TopologyPlacement placement);
 
 //------------------------
 // Benchmark #1: Fairness 
 //------------------------
 
-void run_fairness_test(void (*acquire_lock)(), void (*release_lock)());
+void run_fairness_test(struct Lock* lock);
+
+//--------------------------------------
+// Benchmark #4: Read-write scalability 
+//--------------------------------------
+
+void run_rw_correctness_test(struct Lock* lock, unsigned read_percent);
+
+void run_rw_performance_test(struct Lock* lock, unsigned read_percent);
+
+//---------------------------------
+// Benchmark #5: Oversubscription 
+//---------------------------------
+
+void run_oversubscription_test(struct Lock* lock);
+
+//---------------------------------
+// Benchmark #7: Timed acquisition 
+//---------------------------------
+
+void run_timed_test(struct Lock* lock, unsigned long long timeout_ns);
+
+//--------------------------
+// Benchmark #8: Throughput 
+//--------------------------
+
+void run_throughput_test(struct Lock* lock, enum TopologyPlacement placement);
+
+//------------------------
+// Benchmark #9: Workload 
+//------------------------
+
+struct Workload
+{
+	// Distinct cache lines read and written in the critical section:
+	unsigned num_cache_lines;
+
+	// Think time between acquisitions is uniform in [0, 2*mean_think_ns]:
+	unsigned mean_think_ns;
+};
+
+void run_workload_test(struct Lock* lock, struct Workload workload);
+
+//------------------------------------
+// Benchmark #10: Sequence lock reads 
+//------------------------------------
+
+void run_seqlock_test(unsigned read_percent);
+
+//-------------------------------------
+// Benchmark #11: Delegation throughput 
+//-------------------------------------
+
+void run_delegation_test(struct Lock* lock);
+
+//---------------------------------
+// Benchmark #12: Barrier crossing 
+//---------------------------------
+
+void run_barrier_test(const struct BarrierOps* ops, int futex_fallback);
+
+//--------------------------------------------
+// Benchmark #13: Oversubscribed tail latency 
+//--------------------------------------------
+
+void run_oversubscribed_latency_test(struct Lock* lock);
+
+//-------------------------------------
+// Benchmark #14: Skewed lock ownership 
+//-------------------------------------
+
+void run_skewed_test(const struct LockOps* ops, unsigned owner_percent);
+
+//----------------------------------------------
+// Benchmark #15: Critical section length sweep 
+//----------------------------------------------
+
+void run_cs_sweep_test(struct Lock* lock, unsigned num_cycles_per_thread);
+
+//-----------------------------------------------
+// Benchmark #16: Adjacent locks (false sharing) 
+//-----------------------------------------------
+
+void run_adjacent_locks_test(const struct LockOps* ops);
 
 #endif // SPIN_LOCK_BENCHMARKS_HPP_INCLUDED
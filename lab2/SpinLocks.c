@@ -1,13 +1,136 @@
-
-
+#define _GNU_SOURCE
 
 #include "SpinLocks.h"
+#include "SpinLocksInline.h"
+#include "Topology.h"
+#include "FastRandom.h"
+#include "LockStats.h"
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <stdint.h>
 #include <immintrin.h>
 #include <time.h>
 #include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+
+//-----------
+// Deadlines 
+//-----------
+
+// Deadline of the untimed acquisition:
+#define NO_DEADLINE (~0ull)
+
+static unsigned long long monotonic_ns()
+{
+	struct timespec now;
+
+	// No value-checking, CLOCK_MONOTONIC is always supported:
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static unsigned long long deadline_after(unsigned long long timeout_ns)
+{
+	return monotonic_ns() + timeout_ns;
+}
+
+static int deadline_passed(unsigned long long deadline)
+{
+	return deadline != NO_DEADLINE && monotonic_ns() >= deadline;
+}
+
+// Don't oversleep the deadline in backoff:
+static void clamp_sleep_to_deadline(struct timespec* to_sleep, unsigned long long deadline)
+{
+	if (deadline == NO_DEADLINE) return;
+
+	unsigned long long now = monotonic_ns();
+	unsigned long long left = (deadline > now)? deadline - now : 0;
+
+	if ((unsigned long long) to_sleep->tv_nsec > left) to_sleep->tv_nsec = left;
+}
+
+//-----------------
+// Instrumentation 
+//-----------------
+// All hooks are empty unless built with -D LOCK_STATS (see LockStats.h).
+
+#define spin_pause()                     \
+	do                                   \
+	{                                    \
+		LOCK_STATS_ADD(num_spins, 1);    \
+		spinloop_pause();                \
+	} while (0)
+
+#define spin_yield()                     \
+	do                                   \
+	{                                    \
+		LOCK_STATS_ADD(num_yields, 1);   \
+		sched_yield();                   \
+	} while (0)
+
+static void backoff_nanosleep(const struct timespec* to_sleep)
+{
+#ifdef LOCK_STATS
+	unsigned long long start = monotonic_ns();
+#endif
+
+	// No value-checking, because it doesn't affect correctness:
+	nanosleep(to_sleep, NULL);
+
+#ifdef LOCK_STATS
+	LOCK_STATS_ADD(num_sleeps, 1);
+	LOCK_STATS_ADD(sleep_ns, monotonic_ns() - start);
+#endif
+}
+
+#ifdef LOCK_STATS
+
+// An acquisition is a handoff if the lock was released after the thread started waiting:
+static void stats_acquired(unsigned long long released_at, unsigned long long wait_start)
+{
+	if (released_at < wait_start) return;
+
+	LOCK_STATS_ADD(num_handoffs, 1);
+	LOCK_STATS_ADD(handoff_cycles, __rdtsc() - released_at);
+}
+
+#define STATS_WAIT_START()   const unsigned long long stats_wait_start = __rdtsc()
+#define STATS_ACQUIRED(lock) stats_acquired((lock)->stats_released_at, stats_wait_start)
+#define STATS_RELEASE(lock)  ((lock)->stats_released_at = __rdtsc())
+#define STATS_INIT(lock)     ((lock)->stats_released_at = 0)
+
+#else
+
+#define STATS_WAIT_START()   do {} while (0)
+#define STATS_ACQUIRED(lock) do {} while (0)
+#define STATS_RELEASE(lock)  do {} while (0)
+#define STATS_INIT(lock)     do {} while (0)
+
+#endif // LOCK_STATS
+
+
+// Backoff jitter 
+
+
+uint32_t fast_random_jitter(uint32_t bound)
+{
+	return fast_random_below(bound);
+}
+
+// rand() serializes its callers on a lock inside libc, kept for comparison:
+uint32_t libc_rand_jitter(uint32_t bound)
+{
+	return (uint32_t) rand() % bound;
+}
+
+BackoffJitter spin_backoff_jitter = fast_random_jitter;
 
 
 // TAS lock 
@@ -20,10 +143,14 @@ const unsigned TAS_MAX_BACKOFF_NANOSECONDS = 64000;
 void TAS_init(struct TAS_Lock* lock)
 {
 	lock->lock_taken = 0;
+
+	STATS_INIT(lock);
 }
 
-void TAS_acquire(struct TAS_Lock* lock)
+static int TAS_acquire_before(struct TAS_Lock* lock, unsigned long long deadline)
 {
+	STATS_WAIT_START();
+
 	unsigned backoff_sleep = TAS_MIN_BACKOFF_NANOSECONDS;
 /*
 Built-in Function: bool __atomic_test_and_set (void *ptr, int memorder)
@@ -35,29 +162,52 @@ All memory orders are valid.
 */
 	for (unsigned cycle_no = 0; __atomic_test_and_set(&lock->lock_taken, __ATOMIC_ACQUIRE); ++cycle_no)
 	{
-		spinloop_pause();
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+
+		spin_pause();
 
 		if (cycle_no == TAS_CYCLES_TO_SPIN)
 		{
+			if (deadline_passed(deadline)) return 0;
+
 			struct timespec to_sleep = {
 				.tv_sec  = 0,
-				.tv_nsec = backoff_sleep + (rand() % TAS_MIN_BACKOFF_NANOSECONDS)
+				.tv_nsec = backoff_sleep + spin_backoff_jitter(TAS_MIN_BACKOFF_NANOSECONDS)
 			};
 
+			clamp_sleep_to_deadline(&to_sleep, deadline);
+
 			if (backoff_sleep < TAS_MAX_BACKOFF_NANOSECONDS) backoff_sleep *= 2;
 			cycle_no = TAS_CYCLES_TO_SPIN - 1;
 
-			// No value-checking, because it doesn't affect correctness
-			nanosleep(&to_sleep, NULL);
+			backoff_nanosleep(&to_sleep);
 		}
 	}
 
-	backoff_sleep = TAS_MIN_BACKOFF_NANOSECONDS;
+	STATS_ACQUIRED(lock);
+	return 1;
+}
+
+void TAS_acquire(struct TAS_Lock* lock)
+{
+	TAS_acquire_before(lock, NO_DEADLINE);
+}
+
+int TAS_try_acquire(struct TAS_Lock* lock)
+{
+	return TAS_try_acquire_inline(lock);
+}
+
+int TAS_acquire_for(struct TAS_Lock* lock, unsigned long long timeout_ns)
+{
+	return TAS_acquire_before(lock, deadline_after(timeout_ns));
 }
 
 void TAS_release(struct TAS_Lock* lock)
 {
-	__atomic_clear(&lock->lock_taken, __ATOMIC_RELEASE);
+	STATS_RELEASE(lock);
+
+	TAS_release_inline(lock);
 }
 /*
 Built-in Function: void __atomic_clear (bool *ptr, int memorder)
@@ -77,10 +227,14 @@ const unsigned TTAS_MAX_BACKOFF_NANOSECONDS = 64000;
 void TTAS_init(struct TTAS_Lock* lock)
 {
 	lock->lock_taken = 0;
+
+	STATS_INIT(lock);
 }
 
-void TTAS_acquire(struct TTAS_Lock* lock)
+static int TTAS_acquire_before(struct TTAS_Lock* lock, unsigned long long deadline)
 {
+	STATS_WAIT_START();
+
 	unsigned backoff_sleep = TTAS_MIN_BACKOFF_NANOSECONDS;
 
 	// On start spin-loop waiting for the lock to be released:
@@ -97,7 +251,7 @@ This is the generic version of an atomic load. It returns the contents of *ptr i
 	*/
 	for (unsigned cycle_no = 0; __atomic_load_n(&lock->lock_taken, __ATOMIC_SEQ_CST) && cycle_no < TTAS_CYCLES_TO_SPIN; ++cycle_no)
 	{
-		spinloop_pause();
+		spin_pause();
 	}
 
 	// Perform exponential backoff:
@@ -105,20 +259,29 @@ This is the generic version of an atomic load. It returns the contents of *ptr i
 	{
 		if (__atomic_load_n(&lock->lock_taken, __ATOMIC_SEQ_CST))
 		{
+			if (deadline_passed(deadline)) return 0;
+
 			struct timespec to_sleep = {
 				.tv_sec  = 0,
-				.tv_nsec = backoff_sleep + (rand() % TTAS_MIN_BACKOFF_NANOSECONDS)
+				.tv_nsec = backoff_sleep + spin_backoff_jitter(TTAS_MIN_BACKOFF_NANOSECONDS)
 			};
 
+			clamp_sleep_to_deadline(&to_sleep, deadline);
+
 			if (backoff_sleep < TTAS_MAX_BACKOFF_NANOSECONDS) backoff_sleep *= 2;
 
-			// No value-checking, because it doesn't affect correctness:
-			nanosleep(&to_sleep, NULL);
+			backoff_nanosleep(&to_sleep);
 
 			continue;
 		}
 
-		if (!__atomic_test_and_set(&lock->lock_taken, __ATOMIC_ACQUIRE)) return;
+		if (!__atomic_test_and_set(&lock->lock_taken, __ATOMIC_ACQUIRE))
+		{
+			STATS_ACQUIRED(lock);
+			return 1;
+		}
+
+		LOCK_STATS_ADD(num_failed_atomics, 1);
 	}
 	/*
 Built-in Function: bool __atomic_test_and_set (void *ptr, int memorder)
@@ -130,9 +293,26 @@ All memory orders are valid.
 */
 }
 
+void TTAS_acquire(struct TTAS_Lock* lock)
+{
+	TTAS_acquire_before(lock, NO_DEADLINE);
+}
+
+int TTAS_try_acquire(struct TTAS_Lock* lock)
+{
+	return TTAS_try_acquire_inline(lock);
+}
+
+int TTAS_acquire_for(struct TTAS_Lock* lock, unsigned long long timeout_ns)
+{
+	return TTAS_acquire_before(lock, deadline_after(timeout_ns));
+}
+
 void TTAS_release(struct TTAS_Lock* lock)
 {
-	__atomic_clear(&lock->lock_taken, __ATOMIC_RELEASE);
+	STATS_RELEASE(lock);
+
+	TTAS_release_inline(lock);
 }
 /*
 Built-in Function: void __atomic_clear (bool *ptr, int memorder)
@@ -147,18 +327,121 @@ The valid memory order variants are __ATOMIC_RELAXED, __ATOMIC_SEQ_CST, and __AT
 // Ticket lock 
 //-------------
 
-const unsigned TICKET_CYCLES_TO_SPIN = 100;
+const unsigned TICKET_CYCLES_TO_SPIN       =   100;
+const unsigned TICKET_SPIN_BUDGET_CYCLES   = 10000;
+
+// Backoff per holder ahead until the average critical section is known, and the cap of one backoff:
+const unsigned TICKET_MIN_BACKOFF_CYCLES   =     100;
+const unsigned TICKET_MAX_BACKOFF_CYCLES   = 1000000;
 
 void TicketLock_init(struct TicketLock* lock)
 {
 	lock->next_ticket = 0;
 	lock->now_serving = 0;
+
+	lock->acquired_at = 0;
+	lock->hold_cycles = 0;
+
+	STATS_INIT(lock);
+}
+
+static void wait_cycles(unsigned long long num_cycles)
+{
+	const unsigned long long until = __rdtsc() + num_cycles;
+
+	while (__rdtsc() < until)
+	{
+		spin_pause();
+	}
+}
+
+// Let num_cycles pass without touching the lock: spin through a short wait, give up the CPU through a long one:
+static void ticket_backoff(unsigned long long num_cycles)
+{
+	if (num_cycles <= TICKET_SPIN_BUDGET_CYCLES)
+	{
+		wait_cycles(num_cycles);
+		return;
+	}
+
+	const unsigned long long until = __rdtsc() + num_cycles;
+
+	while (__rdtsc() < until)
+	{
+		spin_yield();
+		/*
+		 sched_yield() causes the calling thread to relinquish the CPU.
+		 The thread is moved to the end of the queue for its static
+		 priority and a new thread gets to run
+		*/
+	}
+}
+
+// Shared by the packed and the split ticket locks:
+static void ticket_wait_for_turn(volatile short* now_serving, volatile unsigned* hold_cycles, short ticket)
+{
+	// Busy-waiting of the next-in-line thread is bounded both in lock reads and in TSC cycles:
+	unsigned num_polls = 0;
+	unsigned long long spin_deadline = 0;
+
+	while (1)
+	{
+		const short distance = ticket - __atomic_load_n(now_serving, __ATOMIC_ACQUIRE);
+		if (distance == 0) return;
+
+		// The next-in-line thread is the only one to poll the lock line:
+		if (distance == 1)
+		{
+			if (num_polls == 0) spin_deadline = __rdtsc() + TICKET_SPIN_BUDGET_CYCLES;
+
+			// Give up the CPU if the lock is taken for too long:
+			if (num_polls < TICKET_CYCLES_TO_SPIN && __rdtsc() < spin_deadline) spin_pause();
+			else                                                                 spin_yield();
+
+			num_polls += 1;
+			continue;
+		}
+
+		// Proportional backoff: wait for the holders ahead before reading the lock line again:
+		unsigned long long per_holder = __atomic_load_n(hold_cycles, __ATOMIC_RELAXED);
+		if (per_holder < TICKET_MIN_BACKOFF_CYCLES) per_holder = TICKET_MIN_BACKOFF_CYCLES;
+
+		unsigned long long backoff = (distance - 1) * per_holder;
+		if (backoff > TICKET_MAX_BACKOFF_CYCLES) backoff = TICKET_MAX_BACKOFF_CYCLES;
+
+		ticket_backoff(backoff);
+	}
+}
+
+// ticket_try_take_turn() and ticket_pass_turn() are in SpinLocksInline.h
+
+static int ticket_take_turn_before(volatile short* next_ticket, volatile short* now_serving, unsigned long long deadline)
+{
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		if (ticket_try_take_turn(next_ticket, now_serving)) return 1;
+
+		if (deadline_passed(deadline)) return 0;
+
+		if (cycle_no < TICKET_CYCLES_TO_SPIN) spin_pause();
+		else                                  spin_yield();
+	}
+}
+
+void TicketLock_wait_for_turn(struct TicketLock* lock, short ticket)
+{
+	ticket_wait_for_turn(&lock->now_serving, &lock->hold_cycles, ticket);
+
+	// Time the critical section, the lock is contended:
+	lock->acquired_at = __rdtsc();
 }
 
 void TicketLock_acquire(struct TicketLock* lock)
 {
+	STATS_WAIT_START();
+
 	// Acquire a ticket in a queue:
-	const short ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_RELAXED);
+	const short ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_ACQUIRE);
 	/*
 	Built-in Function: type __atomic_fetch_add (type *ptr, type val, int memorder)
 
@@ -167,24 +450,1924 @@ Operations on pointer arguments are performed as if the operands were of the uin
 That is, they are not scaled by the size of the type to which the pointer points.
 	*/
 
-	// On start spin-loop waiting for the lock to be released:
-	for (unsigned cycle_no = 0; lock->now_serving != ticket && cycle_no < TTAS_CYCLES_TO_SPIN; ++cycle_no)
+	if (ticket != __atomic_load_n(&lock->now_serving, __ATOMIC_ACQUIRE)) TicketLock_wait_for_turn(lock, ticket);
+
+	STATS_ACQUIRED(lock);
+}
+
+// Untimed acquisitions keep their FIFO place in the queue:
+static int TicketLock_acquire_before(struct TicketLock* lock, unsigned long long deadline)
+{
+	if (deadline == NO_DEADLINE)
 	{
-		spinloop_pause();
+		TicketLock_acquire(lock);
+		return 1;
 	}
 
-	while (__atomic_load_n(&lock->now_serving, __ATOMIC_ACQUIRE) != ticket)
+	STATS_WAIT_START();
+
+	if (!ticket_take_turn_before(&lock->next_ticket, &lock->now_serving, deadline)) return 0;
+
+	STATS_ACQUIRED(lock);
+
+	lock->acquired_at = __rdtsc();
+	return 1;
+}
+
+int TicketLock_try_acquire(struct TicketLock* lock)
+{
+	return TicketLock_try_acquire_inline(lock);
+}
+
+int TicketLock_acquire_for(struct TicketLock* lock, unsigned long long timeout_ns)
+{
+	return TicketLock_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void TicketLock_release(struct TicketLock* lock)
+{
+	STATS_RELEASE(lock);
+
+	TicketLock_release_inline(lock);
+}
+
+//-------------------
+// Split ticket lock 
+//-------------------
+
+void SplitTicketLock_init(struct SplitTicketLock* lock)
+{
+	lock->next_ticket = 0;
+	lock->now_serving = 0;
+
+	lock->acquired_at = 0;
+	lock->hold_cycles = 0;
+
+	STATS_INIT(lock);
+}
+
+void SplitTicketLock_wait_for_turn(struct SplitTicketLock* lock, short ticket)
+{
+	ticket_wait_for_turn(&lock->now_serving, &lock->hold_cycles, ticket);
+
+	lock->acquired_at = __rdtsc();
+}
+
+void SplitTicketLock_acquire(struct SplitTicketLock* lock)
+{
+	STATS_WAIT_START();
+
+	const short ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_ACQUIRE);
+
+	if (ticket != __atomic_load_n(&lock->now_serving, __ATOMIC_ACQUIRE)) SplitTicketLock_wait_for_turn(lock, ticket);
+
+	STATS_ACQUIRED(lock);
+}
+
+int SplitTicketLock_try_acquire(struct SplitTicketLock* lock)
+{
+	return SplitTicketLock_try_acquire_inline(lock);
+}
+
+int SplitTicketLock_acquire_for(struct SplitTicketLock* lock, unsigned long long timeout_ns)
+{
+	STATS_WAIT_START();
+
+	if (!ticket_take_turn_before(&lock->next_ticket, &lock->now_serving, deadline_after(timeout_ns))) return 0;
+
+	STATS_ACQUIRED(lock);
+
+	lock->acquired_at = __rdtsc();
+	return 1;
+}
+
+void SplitTicketLock_release(struct SplitTicketLock* lock)
+{
+	STATS_RELEASE(lock);
+
+	SplitTicketLock_release_inline(lock);
+}
+
+//----------
+// CLH lock 
+//----------
+
+const unsigned CLH_CYCLES_TO_SPIN = 100;
+
+// Every thread keeps a cache of free queue nodes.
+// A node migrates between threads: the new lock holder adopts its predecessor's node,
+// so the total number of nodes stays constant and only the first acquisition allocates.
+static _Thread_local struct CLH_Node* CLH_free_nodes = NULL;
+
+static pthread_once_t CLH_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  CLH_cache_key;
+
+static void CLH_free_node_cache(void* arg)
+{
+	struct CLH_Node* node = (struct CLH_Node*) arg;
+
+	while (node != NULL)
 	{
-		sched_yield();
-		/*
-		 sched_yield() causes the calling thread to relinquish the CPU.
-       The thread is moved to the end of the queue for its static
-       priority and a new thread gets to run
-       */
+		struct CLH_Node* next = node->next_free;
+
+		free(node);
+
+		node = next;
 	}
 }
 
-void TicketLock_release(struct TicketLock* lock)
+static void CLH_create_cache_key()
+{
+	// No value-checking: without the key the cache is just leaked on thread exit
+	pthread_key_create(&CLH_cache_key, CLH_free_node_cache);
+}
+
+static struct CLH_Node* CLH_allocate_node()
+{
+	struct CLH_Node* node = aligned_alloc(L1D_LINESIZE, sizeof(struct CLH_Node));
+	if (node == NULL) return NULL;
+
+	node->state     = CLH_AVAILABLE;
+	node->next_free = NULL;
+
+	STATS_INIT(node);
+
+	return node;
+}
+
+static struct CLH_Node* CLH_get_free_node()
+{
+	struct CLH_Node* node = CLH_free_nodes;
+
+	if (node != NULL)
+	{
+		CLH_free_nodes = node->next_free;
+		pthread_setspecific(CLH_cache_key, CLH_free_nodes);
+
+		return node;
+	}
+
+	// First acquisition by the thread:
+	pthread_once(&CLH_key_once, CLH_create_cache_key);
+
+	node = CLH_allocate_node();
+	if (node == NULL)
+	{
+		fprintf(stderr, "[Error] Unable to allocate CLH queue node\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return node;
+}
+
+static void CLH_put_free_node(struct CLH_Node* node)
+{
+	node->next_free = CLH_free_nodes;
+	CLH_free_nodes  = node;
+
+	// Let the thread-exit destructor see the whole cache:
+	pthread_setspecific(CLH_cache_key, CLH_free_nodes);
+}
+
+int CLH_init(struct CLH_Lock* lock)
+{
+	// The queue always ends with a released dummy node:
+	lock->tail = CLH_allocate_node();
+	if (lock->tail == NULL) return -1;
+
+	lock->holder_node = NULL;
+
+	return 0;
+}
+
+// Timed-out waiters abandon their nodes (M. Scott, W. Scherer "Scalable Queue-Based Spin Locks with Timeout"):
+// the node's state then points to the waiter's predecessor and the successor skips over it.
+static int CLH_acquire_before(struct CLH_Lock* lock, unsigned long long deadline)
+{
+	STATS_WAIT_START();
+
+	struct CLH_Node* node = CLH_get_free_node();
+
+	__atomic_store_n(&node->state, CLH_WAITING, __ATOMIC_RELAXED);
+
+	// Enqueue with a single atomic swap:
+	struct CLH_Node* pred = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+
+	// Spin-loop on the predecessor's node:
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		struct CLH_Node* pred_state = __atomic_load_n(&pred->state, __ATOMIC_ACQUIRE);
+
+		if (pred_state == CLH_AVAILABLE)
+		{
+			STATS_ACQUIRED(pred);
+
+			// Nobody else looks at the predecessor's node, so it's ours to reuse:
+			CLH_put_free_node(pred);
+
+			lock->holder_node = node;
+			return 1;
+		}
+
+		if (pred_state != CLH_WAITING)
+		{
+			// The predecessor has timed out, skip its node:
+			CLH_put_free_node(pred);
+
+			pred = pred_state;
+			continue;
+		}
+
+		if (deadline_passed(deadline))
+		{
+			// Nobody is behind us, just unlink the node:
+			struct CLH_Node* expected = node;
+			if (__atomic_compare_exchange_n(&lock->tail, &expected, pred, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+			{
+				CLH_put_free_node(node);
+				return 0;
+			}
+
+			LOCK_STATS_ADD(num_failed_atomics, 1);
+
+			// Otherwise the successor will skip the node and reuse it:
+			__atomic_store_n(&node->state, pred, __ATOMIC_RELEASE);
+			return 0;
+		}
+
+		if (cycle_no < CLH_CYCLES_TO_SPIN) spin_pause();
+		else                               spin_yield();
+	}
+}
+
+void CLH_acquire(struct CLH_Lock* lock)
+{
+	CLH_acquire_before(lock, NO_DEADLINE);
+}
+
+int CLH_try_acquire(struct CLH_Lock* lock)
+{
+	// The tail node can't be peeked at safely (its successor may recycle it),
+	// so enqueue and leave the queue on the first busy predecessor:
+	return CLH_acquire_before(lock, 0);
+}
+
+int CLH_acquire_for(struct CLH_Lock* lock, unsigned long long timeout_ns)
 {
-	__atomic_fetch_add(&lock->now_serving, 1, __ATOMIC_RELEASE);
+	return CLH_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void CLH_release(struct CLH_Lock* lock)
+{
+	struct CLH_Node* node = lock->holder_node;
+
+	// The successor reads the release time from the node it spins on:
+	STATS_RELEASE(node);
+
+	// The successor takes over the node:
+	__atomic_store_n(&node->state, CLH_AVAILABLE, __ATOMIC_RELEASE);
+}
+
+void CLH_destroy(struct CLH_Lock* lock)
+{
+	// Assumption: the lock is not taken, so the tail node belongs to the lock 
+	free(lock->tail);
+
+	lock->tail = NULL;
+}
+
+//---------------------
+// Anderson array lock 
+//---------------------
+// T. Anderson "The Performance of Spin Lock Alternatives for Shared-Memory Multiprocessors"
+
+const unsigned ANDERSON_CYCLES_TO_SPIN = 100;
+
+int AndersonLock_init(struct AndersonLock* lock, unsigned capacity)
+{
+	if (capacity == ANDERSON_DEFAULT_CAPACITY) capacity = topology_num_cpus();
+
+	// Slot of a ticket is its low bits, so the ticket counter may wrap around:
+	lock->num_slots = 1;
+	while (lock->num_slots < capacity) lock->num_slots *= 2;
+
+	lock->slots = aligned_alloc(L1D_LINESIZE, lock->num_slots * sizeof(struct AndersonSlot));
+	if (lock->slots == NULL) return -1;
+
+	// Every slot holds the already served ticket of the previous round:
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		lock->slots[slot_i].grant = slot_i - lock->num_slots;
+
+		STATS_INIT(&lock->slots[slot_i]);
+	}
+
+	lock->slots[0].grant = 0;
+
+	lock->next_ticket   = 0;
+	lock->holder_ticket = 0;
+
+	return 0;
+}
+
+static struct AndersonSlot* anderson_slot(struct AndersonLock* lock, unsigned ticket)
+{
+	return &lock->slots[ticket & (lock->num_slots - 1)];
+}
+
+void AndersonLock_acquire(struct AndersonLock* lock)
+{
+	STATS_WAIT_START();
+
+	const unsigned ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_RELAXED);
+
+	// Spin on the own slot only:
+	volatile unsigned* grant = &anderson_slot(lock, ticket)->grant;
+
+	for (unsigned cycle_no = 0; __atomic_load_n(grant, __ATOMIC_ACQUIRE) != ticket; ++cycle_no)
+	{
+		if (cycle_no < ANDERSON_CYCLES_TO_SPIN) spin_pause();
+		else                                    spin_yield();
+	}
+
+	STATS_ACQUIRED(anderson_slot(lock, ticket));
+
+	lock->holder_ticket = ticket;
+}
+
+// A ticket is taken only if it is granted right away, so no slot is ever abandoned:
+int AndersonLock_try_acquire(struct AndersonLock* lock)
+{
+	unsigned ticket = __atomic_load_n(&lock->next_ticket, __ATOMIC_RELAXED);
+
+	if (__atomic_load_n(&anderson_slot(lock, ticket)->grant, __ATOMIC_ACQUIRE) != ticket) return 0;
+
+	if (!__atomic_compare_exchange_n(&lock->next_ticket, &ticket, ticket + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+		return 0;
+	}
+
+	lock->holder_ticket = ticket;
+	return 1;
+}
+
+// Untimed acquisitions keep their FIFO place in the queue:
+static int AndersonLock_acquire_before(struct AndersonLock* lock, unsigned long long deadline)
+{
+	if (deadline == NO_DEADLINE)
+	{
+		AndersonLock_acquire(lock);
+		return 1;
+	}
+
+	STATS_WAIT_START();
+
+	for (unsigned cycle_no = 0; !AndersonLock_try_acquire(lock); ++cycle_no)
+	{
+		if (deadline_passed(deadline)) return 0;
+
+		if (cycle_no < ANDERSON_CYCLES_TO_SPIN) spin_pause();
+		else                                    spin_yield();
+	}
+
+	STATS_ACQUIRED(anderson_slot(lock, lock->holder_ticket));
+
+	return 1;
+}
+
+int AndersonLock_acquire_for(struct AndersonLock* lock, unsigned long long timeout_ns)
+{
+	return AndersonLock_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void AndersonLock_release(struct AndersonLock* lock)
+{
+	const unsigned next_ticket = lock->holder_ticket + 1;
+
+	// Only the next waiter's line is written, the release time included:
+	STATS_RELEASE(anderson_slot(lock, next_ticket));
+
+	__atomic_store_n(&anderson_slot(lock, next_ticket)->grant, next_ticket, __ATOMIC_RELEASE);
+}
+
+void AndersonLock_destroy(struct AndersonLock* lock)
+{
+	free(lock->slots);
+
+	lock->slots     = NULL;
+	lock->num_slots = 0;
+}
+
+//---------------------------
+// Time-published queue lock 
+//---------------------------
+// B. He, W. Scherer, M. Scott "Preemption Adaptivity in Time-Published Queue-Based Spin Locks"
+
+const unsigned           TP_CYCLES_TO_SPIN = 100;
+const unsigned long long TP_STALE_CYCLES   = 100000;
+
+enum
+{
+	TP_WAITING,
+	TP_GRANTED,
+	TP_REMOVED
+};
+
+// Every thread keeps a cache of free queue nodes, a node is free again once its owner releases the lock:
+static _Thread_local struct TimePublishedNode* TP_free_nodes = NULL;
+
+static pthread_once_t TP_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  TP_cache_key;
+
+static void TP_free_node_cache(void* arg)
+{
+	struct TimePublishedNode* node = (struct TimePublishedNode*) arg;
+
+	while (node != NULL)
+	{
+		struct TimePublishedNode* next = node->next_free;
+
+		free(node);
+
+		node = next;
+	}
+}
+
+static void TP_create_cache_key()
+{
+	// No value-checking: without the key the cache is just leaked on thread exit
+	pthread_key_create(&TP_cache_key, TP_free_node_cache);
+}
+
+static struct TimePublishedNode* TP_get_free_node()
+{
+	struct TimePublishedNode* node = TP_free_nodes;
+
+	if (node != NULL)
+	{
+		TP_free_nodes = node->next_free;
+		pthread_setspecific(TP_cache_key, TP_free_nodes);
+
+		return node;
+	}
+
+	pthread_once(&TP_key_once, TP_create_cache_key);
+
+	node = aligned_alloc(L1D_LINESIZE, sizeof(struct TimePublishedNode));
+	if (node == NULL)
+	{
+		fprintf(stderr, "[Error] Unable to allocate time-published queue node\n");
+		exit(EXIT_FAILURE);
+	}
+
+	STATS_INIT(node);
+
+	return node;
+}
+
+static void TP_put_free_node(struct TimePublishedNode* node)
+{
+	node->next_free = TP_free_nodes;
+	TP_free_nodes   = node;
+
+	// Let the thread-exit destructor see the whole cache:
+	pthread_setspecific(TP_cache_key, TP_free_nodes);
+}
+
+void TimePublishedLock_init(struct TimePublishedLock* lock)
+{
+	lock->tail        = NULL;
+	lock->holder_node = NULL;
+	lock->acquired_at = 0;
+}
+
+static void TP_took_lock(struct TimePublishedLock* lock, struct TimePublishedNode* node)
+{
+	lock->holder_node = node;
+
+	__atomic_store_n(&lock->acquired_at, __rdtsc(), __ATOMIC_RELAXED);
+}
+
+void TimePublishedLock_acquire(struct TimePublishedLock* lock)
+{
+	STATS_WAIT_START();
+
+	struct TimePublishedNode* node = TP_get_free_node();
+
+	// A skipped waiter enqueues its node again:
+	while (1)
+	{
+		node->next      = NULL;
+		node->state     = TP_WAITING;
+		node->heartbeat = __rdtsc();
+
+		struct TimePublishedNode* pred = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+
+		// The queue was empty:
+		if (pred == NULL) break;
+
+		__atomic_store_n(&pred->next, node, __ATOMIC_RELEASE);
+
+		unsigned state;
+
+		for (unsigned cycle_no = 0; (state = __atomic_load_n(&node->state, __ATOMIC_ACQUIRE)) == TP_WAITING; ++cycle_no)
+		{
+			unsigned long long now = __rdtsc();
+
+			__atomic_store_n(&node->heartbeat, now, __ATOMIC_RELAXED);
+
+			// Spinning is useless while the holder is preempted:
+			if (cycle_no < TP_CYCLES_TO_SPIN && now - __atomic_load_n(&lock->acquired_at, __ATOMIC_RELAXED) < TP_STALE_CYCLES)
+			{
+				spin_pause();
+			}
+			else
+			{
+				spin_yield();
+			}
+		}
+
+		if (state == TP_GRANTED) break;
+	}
+
+	// Only a granted node carries a release time newer than the wait start:
+	STATS_ACQUIRED(node);
+
+	TP_took_lock(lock, node);
+}
+
+int TimePublishedLock_try_acquire(struct TimePublishedLock* lock)
+{
+	if (__atomic_load_n(&lock->tail, __ATOMIC_RELAXED) != NULL) return 0;
+
+	struct TimePublishedNode* node = TP_get_free_node();
+
+	node->next  = NULL;
+	node->state = TP_WAITING;
+
+	struct TimePublishedNode* empty = NULL;
+
+	if (!__atomic_compare_exchange_n(&lock->tail, &empty, node, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+
+		TP_put_free_node(node);
+		return 0;
+	}
+
+	TP_took_lock(lock, node);
+	return 1;
+}
+
+void TimePublishedLock_release(struct TimePublishedLock* lock)
+{
+	struct TimePublishedNode* node = lock->holder_node;
+	struct TimePublishedNode* succ = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+	if (succ == NULL)
+	{
+		// No waiters:
+		struct TimePublishedNode* expected = node;
+
+		if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+			TP_put_free_node(node);
+			return;
+		}
+
+		// A successor is linking itself in:
+		for (unsigned cycle_no = 0; (succ = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == NULL; ++cycle_no)
+		{
+			if (cycle_no < TP_CYCLES_TO_SPIN) spin_pause();
+			else                              spin_yield();
+		}
+	}
+
+	// Skip stale waiters, but never the last one, so the tail stays in the queue:
+	while (1)
+	{
+		struct TimePublishedNode* next = __atomic_load_n(&succ->next, __ATOMIC_ACQUIRE);
+
+		if (next == NULL || __rdtsc() - __atomic_load_n(&succ->heartbeat, __ATOMIC_RELAXED) < TP_STALE_CYCLES) break;
+
+		// The skipped waiter may reuse its node right after this store:
+		__atomic_store_n(&succ->state, TP_REMOVED, __ATOMIC_RELEASE);
+
+		succ = next;
+	}
+
+	STATS_RELEASE(succ);
+
+	__atomic_store_n(&succ->state, TP_GRANTED, __ATOMIC_RELEASE);
+
+	TP_put_free_node(node);
+}
+
+//-------------
+// Cohort lock 
+//-------------
+
+const unsigned COHORT_MAX_LOCAL_HANDOFFS = 64;
+
+int CohortLock_init(struct CohortLock* lock)
+{
+	TicketLock_init(&lock->global);
+
+	lock->num_nodes = topology_num_numa_nodes();
+
+	lock->local = aligned_alloc(L1D_LINESIZE, lock->num_nodes * sizeof(struct CohortLocalLock));
+	if (lock->local == NULL) return -1;
+
+	for (unsigned node = 0; node < lock->num_nodes; ++node)
+	{
+		TicketLock_init(&lock->local[node].lock);
+
+		lock->local[node].global_taken = 0;
+		lock->local[node].num_handoffs = 0;
+	}
+
+	lock->holder_local = NULL;
+
+	return 0;
+}
+
+static int CohortLock_acquire_before(struct CohortLock* lock, unsigned long long deadline)
+{
+	// The thread may migrate afterwards, it only affects performance:
+	struct CohortLocalLock* local = &lock->local[topology_current_numa_node() % lock->num_nodes];
+
+	if (!TicketLock_acquire_before(&local->lock, deadline)) return 0;
+
+	// The global lock may have been passed by the previous local owner:
+	if (!local->global_taken)
+	{
+		if (!TicketLock_acquire_before(&lock->global, deadline))
+		{
+			TicketLock_release(&local->lock);
+			return 0;
+		}
+
+		local->global_taken = 1;
+	}
+
+	lock->holder_local = local;
+	return 1;
+}
+
+void CohortLock_acquire(struct CohortLock* lock)
+{
+	CohortLock_acquire_before(lock, NO_DEADLINE);
+}
+
+int CohortLock_try_acquire(struct CohortLock* lock)
+{
+	return CohortLock_acquire_before(lock, 0);
+}
+
+int CohortLock_acquire_for(struct CohortLock* lock, unsigned long long timeout_ns)
+{
+	return CohortLock_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void CohortLock_release(struct CohortLock* lock)
+{
+	struct CohortLocalLock* local = lock->holder_local;
+
+	// Somebody from the same node is already waiting for a ticket:
+	short waiting = __atomic_load_n(&local->lock.next_ticket, __ATOMIC_RELAXED) - local->lock.now_serving - 1;
+
+	if (waiting > 0 && local->num_handoffs < COHORT_MAX_LOCAL_HANDOFFS)
+	{
+		// Keep the global lock inside the cohort:
+		local->num_handoffs += 1;
+	}
+	else
+	{
+		// Let other nodes in:
+		local->num_handoffs = 0;
+		local->global_taken = 0;
+
+		TicketLock_release(&lock->global);
+	}
+
+	TicketLock_release(&local->lock);
+}
+
+void CohortLock_destroy(struct CohortLock* lock)
+{
+	free(lock->local);
+
+	lock->local     = NULL;
+	lock->num_nodes = 0;
+}
+
+//-------------
+// Hybrid lock 
+//-------------
+
+const unsigned HYBRID_CYCLES_TO_SPIN = 100;
+
+static void futex_wait(volatile int* address, int expected_value, const struct timespec* timeout)
+{
+#ifdef LOCK_STATS
+	unsigned long long start = monotonic_ns();
+#endif
+
+	// Sleeps only if *address still holds the expected value.
+	// No value-checking: spurious wake-ups, timeouts and EAGAIN are handled by the caller's loop
+	syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected_value, timeout, NULL, 0);
+
+#ifdef LOCK_STATS
+	LOCK_STATS_ADD(num_sleeps, 1);
+	LOCK_STATS_ADD(sleep_ns, monotonic_ns() - start);
+#endif
+}
+
+static void futex_wake(volatile int* address, int num_to_wake)
+{
+	syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, num_to_wake, NULL, NULL, 0);
+}
+
+void HybridLock_init(struct HybridLock* lock)
+{
+	lock->lock_taken  = 0;
+	lock->num_waiters = 0;
+
+	STATS_INIT(lock);
+}
+
+static int HybridLock_acquire_before(struct HybridLock* lock, unsigned long long deadline)
+{
+	STATS_WAIT_START();
+
+	// Spin phase (test-and-test-and-set):
+	for (unsigned cycle_no = 0; cycle_no < HYBRID_CYCLES_TO_SPIN; ++cycle_no)
+	{
+		if (HybridLock_try_acquire(lock))
+		{
+			STATS_ACQUIRED(lock);
+			return 1;
+		}
+
+		spin_pause();
+	}
+
+	// Park phase, register as a waiter first (pairs with the release path check):
+	__atomic_add_fetch(&lock->num_waiters, 1, __ATOMIC_SEQ_CST);
+
+	int acquired = 1;
+	while (__atomic_exchange_n(&lock->lock_taken, 1, __ATOMIC_SEQ_CST))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+
+		if (deadline == NO_DEADLINE)
+		{
+			futex_wait(&lock->lock_taken, 1, NULL);
+			continue;
+		}
+
+		unsigned long long now = monotonic_ns();
+		if (now >= deadline)
+		{
+			acquired = 0;
+			break;
+		}
+
+		struct timespec timeout = {
+			.tv_sec  = (deadline - now) / 1000000000ull,
+			.tv_nsec = (deadline - now) % 1000000000ull
+		};
+
+		futex_wait(&lock->lock_taken, 1, &timeout);
+	}
+
+	__atomic_sub_fetch(&lock->num_waiters, 1, __ATOMIC_RELAXED);
+
+	if (acquired) STATS_ACQUIRED(lock);
+
+	return acquired;
+}
+
+void HybridLock_acquire(struct HybridLock* lock)
+{
+	HybridLock_acquire_before(lock, NO_DEADLINE);
+}
+
+int HybridLock_try_acquire(struct HybridLock* lock)
+{
+	if (__atomic_load_n(&lock->lock_taken, __ATOMIC_RELAXED)) return 0;
+
+	if (__atomic_exchange_n(&lock->lock_taken, 1, __ATOMIC_ACQUIRE))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+		return 0;
+	}
+
+	return 1;
+}
+
+int HybridLock_acquire_for(struct HybridLock* lock, unsigned long long timeout_ns)
+{
+	return HybridLock_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void HybridLock_release(struct HybridLock* lock)
+{
+	STATS_RELEASE(lock);
+
+	__atomic_store_n(&lock->lock_taken, 0, __ATOMIC_SEQ_CST);
+
+	// Either we see the waiter here, or the waiter sees the lock released:
+	if (__atomic_load_n(&lock->num_waiters, __ATOMIC_SEQ_CST) != 0)
+	{
+		futex_wake(&lock->lock_taken, 1);
+	}
+}
+
+//-------------
+// Biased lock 
+//-------------
+// K. Kawachiya, A. Koseki, T. Onodera "Lock Reservation: Java Locks Can Mostly Do Without Atomic Operations"
+
+const unsigned           BIASED_CYCLES_TO_SPIN      = 100;
+const unsigned           BIASED_LOCK_REVOKE_RATIO   = 16;
+const unsigned long long BIASED_LOCK_MIN_HANDSHAKES = 64;
+
+// Owner's token once the bias is revoked for good, matches no thread:
+#define BIASED_REVOKED (~(uintptr_t) 0)
+
+// How the holder took the lock:
+enum
+{
+	BIASED_HELD_BY_OWNER,
+	BIASED_HELD_BY_FALLBACK,
+	BIASED_HELD_BY_HANDSHAKE
+};
+
+// Any per-thread address is a distinct token, neither 0 nor BIASED_REVOKED:
+static _Thread_local char biased_thread_token;
+
+static pthread_once_t biased_membarrier_once = PTHREAD_ONCE_INIT;
+static int            biased_membarrier_registered = 0;
+
+static void biased_register_membarrier()
+{
+	biased_membarrier_registered = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+}
+
+// Orders the owner's store of owner_busy before its load of revoke_pending:
+static inline void biased_owner_fence()
+{
+	if (biased_membarrier_registered) __atomic_signal_fence(__ATOMIC_SEQ_CST);
+	else                              memory_barrier();
+}
+
+// The other side of the handshake, a full fence on every CPU running one of our threads:
+static void biased_remote_fence()
+{
+	if (biased_membarrier_registered) syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+	else                              memory_barrier();
+}
+
+void BiasedLock_init(struct BiasedLock* lock)
+{
+	pthread_once(&biased_membarrier_once, biased_register_membarrier);
+
+	lock->owner_busy             = 0;
+	lock->num_owner_acquisitions = 0;
+	lock->bias_owner             = 0;
+
+	lock->revoke_pending = 0;
+	lock->holder_mode    = BIASED_HELD_BY_OWNER;
+	lock->num_handshakes = 0;
+
+	TTAS_init(&lock->fallback);
+}
+
+// The first thread to take the lock becomes its owner:
+static uintptr_t BiasedLock_self(struct BiasedLock* lock)
+{
+	uintptr_t self  = (uintptr_t) &biased_thread_token;
+	uintptr_t empty = 0;
+
+	if (__atomic_load_n(&lock->bias_owner, __ATOMIC_RELAXED) == 0)
+	{
+		__atomic_compare_exchange_n(&lock->bias_owner, &empty, self, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	}
+
+	return self;
+}
+
+static int BiasedLock_owner_try_acquire(struct BiasedLock* lock, uintptr_t self)
+{
+	if (__atomic_load_n(&lock->bias_owner, __ATOMIC_RELAXED) != self) return 0;
+
+	__atomic_store_n(&lock->owner_busy, 1, __ATOMIC_RELAXED);
+
+	biased_owner_fence();
+
+	// Another thread is revoking the bias, or has revoked it for good:
+	if (__atomic_load_n(&lock->revoke_pending, __ATOMIC_ACQUIRE))
+	{
+		__atomic_store_n(&lock->owner_busy, 0, __ATOMIC_RELEASE);
+		return 0;
+	}
+
+	__atomic_store_n(&lock->num_owner_acquisitions, lock->num_owner_acquisitions + 1, __ATOMIC_RELAXED);
+	return 1;
+}
+
+// Called with the fallback lock held, returns 0 if the owner is in its critical section and we don't wait:
+static int BiasedLock_revoke_bias(struct BiasedLock* lock, uintptr_t self, int wait)
+{
+	uintptr_t owner = __atomic_load_n(&lock->bias_owner, __ATOMIC_RELAXED);
+
+	// The owner doesn't race with itself, and a revoked bias needs no handshake:
+	if (owner == self || owner == BIASED_REVOKED)
+	{
+		lock->holder_mode = BIASED_HELD_BY_FALLBACK;
+		return 1;
+	}
+
+	__atomic_store_n(&lock->revoke_pending, 1, __ATOMIC_RELAXED);
+
+	// Either the owner sees revoke_pending, or we see owner_busy:
+	biased_remote_fence();
+
+	for (unsigned cycle_no = 0; __atomic_load_n(&lock->owner_busy, __ATOMIC_ACQUIRE); ++cycle_no)
+	{
+		if (!wait)
+		{
+			__atomic_store_n(&lock->revoke_pending, 0, __ATOMIC_RELEASE);
+			return 0;
+		}
+
+		if (cycle_no < BIASED_CYCLES_TO_SPIN) spin_pause();
+		else                                  spin_yield();
+	}
+
+	lock->num_handshakes += 1;
+
+	// Handshakes cost a system call each, give up the bias if they are frequent.
+	// revoke_pending stays set, so an owner that still sees itself as the owner backs off:
+	if (lock->num_handshakes >= BIASED_LOCK_MIN_HANDSHAKES &&
+	    lock->num_handshakes * BIASED_LOCK_REVOKE_RATIO > __atomic_load_n(&lock->num_owner_acquisitions, __ATOMIC_RELAXED))
+	{
+		__atomic_store_n(&lock->bias_owner, BIASED_REVOKED, __ATOMIC_RELAXED);
+
+		lock->holder_mode = BIASED_HELD_BY_FALLBACK;
+		return 1;
+	}
+
+	lock->holder_mode = BIASED_HELD_BY_HANDSHAKE;
+	return 1;
+}
+
+void BiasedLock_acquire(struct BiasedLock* lock)
+{
+	uintptr_t self = BiasedLock_self(lock);
+
+	if (BiasedLock_owner_try_acquire(lock, self)) return;
+
+	TTAS_acquire(&lock->fallback);
+
+	BiasedLock_revoke_bias(lock, self, 1);
+}
+
+int BiasedLock_try_acquire(struct BiasedLock* lock)
+{
+	uintptr_t self = BiasedLock_self(lock);
+
+	if (BiasedLock_owner_try_acquire(lock, self)) return 1;
+
+	if (!TTAS_try_acquire(&lock->fallback)) return 0;
+
+	if (BiasedLock_revoke_bias(lock, self, 0)) return 1;
+
+	TTAS_release(&lock->fallback);
+	return 0;
+}
+
+void BiasedLock_release(struct BiasedLock* lock)
+{
+	unsigned holder_mode = lock->holder_mode;
+
+	if (holder_mode == BIASED_HELD_BY_OWNER)
+	{
+		__atomic_store_n(&lock->owner_busy, 0, __ATOMIC_RELEASE);
+		return;
+	}
+
+	lock->holder_mode = BIASED_HELD_BY_OWNER;
+
+	// Let the owner back in:
+	if (holder_mode == BIASED_HELD_BY_HANDSHAKE)
+	{
+		__atomic_store_n(&lock->revoke_pending, 0, __ATOMIC_RELEASE);
+	}
+
+	TTAS_release(&lock->fallback);
+}
+
+//---------------
+// Adaptive lock 
+//---------------
+
+const unsigned ADAPTIVE_AVERAGING_SHIFT  = 3;
+const unsigned ADAPTIVE_SPIN_HOLD_TIMES  = 4;
+const unsigned ADAPTIVE_MIN_SPIN_CYCLES  = 100;
+const unsigned ADAPTIVE_MAX_SPIN_CYCLES  = 20000;
+const unsigned ADAPTIVE_MAX_BACKOFF      = 4000;
+
+// About a futex park and wake-up round trip:
+const unsigned ADAPTIVE_PARK_CYCLES      = 40000;
+
+// Longer samples (a preempted holder) would swamp the averages:
+const unsigned ADAPTIVE_MAX_SAMPLE_CYCLES = 1u << 24;
+
+static void adaptive_average(volatile unsigned* average, unsigned long long sample)
+{
+	long long cur = (sample < ADAPTIVE_MAX_SAMPLE_CYCLES)? sample : ADAPTIVE_MAX_SAMPLE_CYCLES;
+	long long old = *average;
+
+	__atomic_store_n(average, old + ((cur - old) >> ADAPTIVE_AVERAGING_SHIFT), __ATOMIC_RELAXED);
+}
+
+static unsigned adaptive_clamp(unsigned long long value, unsigned min, unsigned max)
+{
+	if (value < min) return min;
+	if (value > max) return max;
+
+	return value;
+}
+
+void AdaptiveLock_init(struct AdaptiveLock* lock)
+{
+	lock->lock_taken  = 0;
+	lock->num_waiters = 0;
+	lock->hold_cycles = 0;
+	lock->wait_cycles = 0;
+	lock->acquired_at = 0;
+
+	STATS_INIT(lock);
+}
+
+static int AdaptiveLock_try_take(struct AdaptiveLock* lock)
+{
+	if (__atomic_load_n(&lock->lock_taken, __ATOMIC_RELAXED)) return 0;
+
+	if (__atomic_exchange_n(&lock->lock_taken, 1, __ATOMIC_ACQUIRE))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+		return 0;
+	}
+
+	return 1;
+}
+
+static void AdaptiveLock_took(struct AdaptiveLock* lock, unsigned long long wait_start)
+{
+	unsigned long long now = __rdtsc();
+
+	adaptive_average(&lock->wait_cycles, now - wait_start);
+
+	// Waiters read it to tell a preempted holder:
+	__atomic_store_n(&lock->acquired_at, now, __ATOMIC_RELAXED);
+}
+
+static int AdaptiveLock_acquire_before(struct AdaptiveLock* lock, unsigned long long deadline)
+{
+	STATS_WAIT_START();
+
+	const unsigned long long start = __rdtsc();
+
+	if (AdaptiveLock_try_take(lock))
+	{
+		STATS_ACQUIRED(lock);
+
+		AdaptiveLock_took(lock, start);
+		return 1;
+	}
+
+	// Thresholds of this acquisition:
+	unsigned average_hold = __atomic_load_n(&lock->hold_cycles, __ATOMIC_RELAXED);
+	unsigned average_wait = __atomic_load_n(&lock->wait_cycles, __ATOMIC_RELAXED);
+
+	unsigned spin_cycles    = adaptive_clamp(ADAPTIVE_SPIN_HOLD_TIMES * (unsigned long long) average_hold,
+	                                         ADAPTIVE_MIN_SPIN_CYCLES, ADAPTIVE_MAX_SPIN_CYCLES);
+	unsigned backoff_cycles = adaptive_clamp(average_hold, 0, ADAPTIVE_MAX_BACKOFF);
+	unsigned park_cycles    = (average_wait > ADAPTIVE_PARK_CYCLES)? spin_cycles : ADAPTIVE_PARK_CYCLES;
+
+	// Spin phase:
+	while (__rdtsc() - start < spin_cycles)
+	{
+		if (AdaptiveLock_try_take(lock))
+		{
+			STATS_ACQUIRED(lock);
+
+			AdaptiveLock_took(lock, start);
+			return 1;
+		}
+
+		spin_pause();
+	}
+
+	// Backoff phase:
+	while (__rdtsc() - start < park_cycles)
+	{
+		if (deadline_passed(deadline)) return 0;
+
+		if (AdaptiveLock_try_take(lock))
+		{
+			STATS_ACQUIRED(lock);
+
+			AdaptiveLock_took(lock, start);
+			return 1;
+		}
+
+		// The holder is running late, it's likely preempted:
+		if (__rdtsc() - __atomic_load_n(&lock->acquired_at, __ATOMIC_RELAXED) > spin_cycles) spin_yield();
+		else                                                                               wait_cycles(backoff_cycles);
+	}
+
+	// Park phase, register as a waiter first (pairs with the release path check):
+	__atomic_add_fetch(&lock->num_waiters, 1, __ATOMIC_SEQ_CST);
+
+	int acquired = 1;
+	while (__atomic_exchange_n(&lock->lock_taken, 1, __ATOMIC_SEQ_CST))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+
+		if (deadline == NO_DEADLINE)
+		{
+			futex_wait(&lock->lock_taken, 1, NULL);
+			continue;
+		}
+
+		unsigned long long now = monotonic_ns();
+		if (now >= deadline)
+		{
+			acquired = 0;
+			break;
+		}
+
+		struct timespec timeout = {
+			.tv_sec  = (deadline - now) / 1000000000ull,
+			.tv_nsec = (deadline - now) % 1000000000ull
+		};
+
+		futex_wait(&lock->lock_taken, 1, &timeout);
+	}
+
+	__atomic_sub_fetch(&lock->num_waiters, 1, __ATOMIC_RELAXED);
+
+	if (!acquired) return 0;
+
+	STATS_ACQUIRED(lock);
+
+	AdaptiveLock_took(lock, start);
+	return 1;
+}
+
+void AdaptiveLock_acquire(struct AdaptiveLock* lock)
+{
+	AdaptiveLock_acquire_before(lock, NO_DEADLINE);
+}
+
+int AdaptiveLock_try_acquire(struct AdaptiveLock* lock)
+{
+	if (!AdaptiveLock_try_take(lock)) return 0;
+
+	__atomic_store_n(&lock->acquired_at, __rdtsc(), __ATOMIC_RELAXED);
+	return 1;
+}
+
+int AdaptiveLock_acquire_for(struct AdaptiveLock* lock, unsigned long long timeout_ns)
+{
+	return AdaptiveLock_acquire_before(lock, deadline_after(timeout_ns));
+}
+
+void AdaptiveLock_release(struct AdaptiveLock* lock)
+{
+	STATS_RELEASE(lock);
+
+	adaptive_average(&lock->hold_cycles, __rdtsc() - lock->acquired_at);
+
+	__atomic_store_n(&lock->lock_taken, 0, __ATOMIC_SEQ_CST);
+
+	// Either we see the waiter here, or the waiter sees the lock released:
+	if (__atomic_load_n(&lock->num_waiters, __ATOMIC_SEQ_CST) != 0)
+	{
+		futex_wake(&lock->lock_taken, 1);
+	}
+}
+
+//-------------------------------------
+// Reader-writer lock (central counter) 
+//-------------------------------------
+
+const unsigned RW_CYCLES_TO_SPIN = 100;
+
+#define RW_WRITER         1u
+#define RW_WRITER_WAITING 2u
+#define RW_READER         4u
+
+void RWLock_init(struct RWLock* lock)
+{
+	lock->state = 0;
+}
+
+void RWLock_read_acquire(struct RWLock* lock)
+{
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		unsigned state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+
+		// Let the writers go first:
+		if (!(state & (RW_WRITER | RW_WRITER_WAITING)))
+		{
+			if (__atomic_compare_exchange_n(&lock->state, &state, state + RW_READER, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+
+			LOCK_STATS_ADD(num_failed_atomics, 1);
+		}
+
+		if (cycle_no < RW_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+}
+
+void RWLock_read_release(struct RWLock* lock)
+{
+	__atomic_fetch_sub(&lock->state, RW_READER, __ATOMIC_RELEASE);
+}
+
+void RWLock_write_acquire(struct RWLock* lock)
+{
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		unsigned state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+
+		// No readers and no writer inside (the waiting bit is ours to clear):
+		if ((state & ~RW_WRITER_WAITING) == 0)
+		{
+			if (__atomic_compare_exchange_n(&lock->state, &state, RW_WRITER, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+
+			LOCK_STATS_ADD(num_failed_atomics, 1);
+			continue;
+		}
+
+		// Stop new readers from coming in:
+		if (!(state & RW_WRITER_WAITING))
+		{
+			__atomic_fetch_or(&lock->state, RW_WRITER_WAITING, __ATOMIC_RELAXED);
+		}
+
+		if (cycle_no < RW_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+}
+
+int RWLock_write_try_acquire(struct RWLock* lock)
+{
+	unsigned state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+
+	// As RWLock_write_acquire(), a waiting writer doesn't keep us out:
+	if ((state & ~RW_WRITER_WAITING) != 0) return 0;
+
+	if (__atomic_compare_exchange_n(&lock->state, &state, RW_WRITER, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return 1;
+
+	LOCK_STATS_ADD(num_failed_atomics, 1);
+	return 0;
+}
+
+void RWLock_write_release(struct RWLock* lock)
+{
+	__atomic_fetch_and(&lock->state, ~RW_WRITER, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------
+// Phase-fair ticket reader-writer lock 
+//--------------------------------------
+// B. Brandenburg, J. Anderson "Spin-Based Reader-Writer Synchronization for Multiprocessor Real-Time Systems"
+
+const unsigned PF_CYCLES_TO_SPIN = 100;
+
+#define PF_READER_INC  0x100u
+#define PF_WRITER_BITS 0x3u
+#define PF_PRESENT     0x2u
+#define PF_PHASE_ID    0x1u
+
+void PhaseFairRWLock_init(struct PhaseFairRWLock* lock)
+{
+	lock->reader_in  = 0;
+	lock->reader_out = 0;
+	lock->writer_in  = 0;
+	lock->writer_out = 0;
+}
+
+void PhaseFairRWLock_read_acquire(struct PhaseFairRWLock* lock)
+{
+	unsigned writer_bits = __atomic_fetch_add(&lock->reader_in, PF_READER_INC, __ATOMIC_ACQUIRE) & PF_WRITER_BITS;
+
+	// A writer is present, wait until its phase is over:
+	for (unsigned cycle_no = 0; writer_bits != 0 &&
+	     (__atomic_load_n(&lock->reader_in, __ATOMIC_ACQUIRE) & PF_WRITER_BITS) == writer_bits; ++cycle_no)
+	{
+		if (cycle_no < PF_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+}
+
+void PhaseFairRWLock_read_release(struct PhaseFairRWLock* lock)
+{
+	__atomic_fetch_add(&lock->reader_out, PF_READER_INC, __ATOMIC_RELEASE);
+}
+
+void PhaseFairRWLock_write_acquire(struct PhaseFairRWLock* lock)
+{
+	// Wait for the preceding writers:
+	unsigned ticket = __atomic_fetch_add(&lock->writer_in, 1, __ATOMIC_RELAXED);
+
+	for (unsigned cycle_no = 0; __atomic_load_n(&lock->writer_out, __ATOMIC_ACQUIRE) != ticket; ++cycle_no)
+	{
+		if (cycle_no < PF_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+
+	// Block new readers and wait for the ones already inside:
+	unsigned writer_bits = PF_PRESENT | (ticket & PF_PHASE_ID);
+	unsigned readers_in  = __atomic_fetch_add(&lock->reader_in, writer_bits, __ATOMIC_ACQUIRE) & ~PF_WRITER_BITS;
+
+	for (unsigned cycle_no = 0; __atomic_load_n(&lock->reader_out, __ATOMIC_ACQUIRE) != readers_in; ++cycle_no)
+	{
+		if (cycle_no < PF_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+}
+
+void PhaseFairRWLock_write_release(struct PhaseFairRWLock* lock)
+{
+	// Start the reader phase:
+	__atomic_fetch_and(&lock->reader_in, ~PF_WRITER_BITS, __ATOMIC_RELEASE);
+
+	__atomic_fetch_add(&lock->writer_out, 1, __ATOMIC_RELEASE);
+}
+
+int PhaseFairRWLock_write_try_acquire(struct PhaseFairRWLock* lock)
+{
+	// Don't take a ticket unless no writer and no reader is inside:
+	unsigned ticket = __atomic_load_n(&lock->writer_out, __ATOMIC_ACQUIRE);
+
+	if (__atomic_load_n(&lock->writer_in, __ATOMIC_RELAXED) != ticket) return 0;
+
+	if ((__atomic_load_n(&lock->reader_in, __ATOMIC_RELAXED) & ~PF_WRITER_BITS) !=
+	    __atomic_load_n(&lock->reader_out, __ATOMIC_RELAXED)) return 0;
+
+	if (!__atomic_compare_exchange_n(&lock->writer_in, &ticket, ticket + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		LOCK_STATS_ADD(num_failed_atomics, 1);
+		return 0;
+	}
+
+	// Block new readers, then check for the ones that came in meanwhile:
+	unsigned writer_bits = PF_PRESENT | (ticket & PF_PHASE_ID);
+	unsigned readers_in  = __atomic_fetch_add(&lock->reader_in, writer_bits, __ATOMIC_ACQUIRE) & ~PF_WRITER_BITS;
+
+	if (__atomic_load_n(&lock->reader_out, __ATOMIC_ACQUIRE) == readers_in) return 1;
+
+	// Back out as an empty writer phase, the readers blocked meanwhile go on:
+	PhaseFairRWLock_write_release(lock);
+	return 0;
+}
+
+//--------------------------------
+// Distributed reader-writer lock 
+//--------------------------------
+
+const unsigned DRW_CYCLES_TO_SPIN = 100;
+
+// Readers count into the slot of the CPU they run on. A reader may leave on another CPU,
+// so a single slot can go below zero: only the sum over all slots is the number of readers
+// (as the per-CPU counters of Linux's percpu_rw_semaphore).
+static struct DistributedRWReaderSlot* DRW_current_slot(struct DistributedRWLock* lock)
+{
+	int cpu = sched_getcpu();
+
+	// Any slot is correct, the one of the current CPU is only faster:
+	if (cpu < 0) cpu = 0;
+
+	return &lock->slots[(unsigned) cpu % lock->num_slots];
+}
+
+// Wraps around below zero, the sum is still exact:
+static unsigned DRW_num_readers(struct DistributedRWLock* lock)
+{
+	unsigned num_readers = 0;
+
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		num_readers += __atomic_load_n(&lock->slots[slot_i].readers, __ATOMIC_SEQ_CST);
+	}
+
+	return num_readers;
+}
+
+int DistributedRWLock_init(struct DistributedRWLock* lock)
+{
+	TicketLock_init(&lock->writers);
+
+	lock->writer_active = 0;
+
+	lock->num_slots = topology_num_cpus();
+
+	lock->slots = aligned_alloc(L1D_LINESIZE, lock->num_slots * sizeof(struct DistributedRWReaderSlot));
+	if (lock->slots == NULL) return -1;
+
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		lock->slots[slot_i].readers = 0;
+	}
+
+	return 0;
+}
+
+void DistributedRWLock_read_acquire(struct DistributedRWLock* lock)
+{
+	while (1)
+	{
+		struct DistributedRWReaderSlot* slot = DRW_current_slot(lock);
+
+		// Announce the reader, then check for the writer (pairs with the writer's store-then-scan):
+		__atomic_fetch_add(&slot->readers, 1, __ATOMIC_SEQ_CST);
+
+		if (!__atomic_load_n(&lock->writer_active, __ATOMIC_SEQ_CST)) return;
+
+		// Step back on the same slot, so the writer never sees the step back without the announcement:
+		__atomic_fetch_sub(&slot->readers, 1, __ATOMIC_RELEASE);
+
+		for (unsigned cycle_no = 0; __atomic_load_n(&lock->writer_active, __ATOMIC_RELAXED); ++cycle_no)
+		{
+			if (cycle_no < DRW_CYCLES_TO_SPIN) spin_pause();
+			else                               spin_yield();
+		}
+	}
+}
+
+void DistributedRWLock_read_release(struct DistributedRWLock* lock)
+{
+	__atomic_fetch_sub(&DRW_current_slot(lock)->readers, 1, __ATOMIC_RELEASE);
+}
+
+void DistributedRWLock_write_acquire(struct DistributedRWLock* lock)
+{
+	TicketLock_acquire(&lock->writers);
+
+	__atomic_store_n(&lock->writer_active, 1, __ATOMIC_SEQ_CST);
+
+	// Wait for the reader indicators to drain. Every admitted reader's announcement is seen,
+	// a departure only lowers the sum, so the sum is never below the number of readers inside:
+	for (unsigned cycle_no = 0; DRW_num_readers(lock) != 0; ++cycle_no)
+	{
+		if (cycle_no < DRW_CYCLES_TO_SPIN) spin_pause();
+		else                               spin_yield();
+	}
+}
+
+int DistributedRWLock_write_try_acquire(struct DistributedRWLock* lock)
+{
+	if (!TicketLock_try_acquire(&lock->writers)) return 0;
+
+	__atomic_store_n(&lock->writer_active, 1, __ATOMIC_SEQ_CST);
+
+	if (DRW_num_readers(lock) == 0) return 1;
+
+	// Readers are inside, let them and the ones stepped back go on:
+	DistributedRWLock_write_release(lock);
+	return 0;
+}
+
+void DistributedRWLock_write_release(struct DistributedRWLock* lock)
+{
+	__atomic_store_n(&lock->writer_active, 0, __ATOMIC_RELEASE);
+
+	TicketLock_release(&lock->writers);
+}
+
+void DistributedRWLock_destroy(struct DistributedRWLock* lock)
+{
+	free(lock->slots);
+
+	lock->slots     = NULL;
+	lock->num_slots = 0;
+}
+
+//----------------------------
+// Sequence lock (seqlock) 
+//----------------------------
+// H. Boehm "Can Seqlocks Get Along With Programming Language Memory Models?"
+
+const unsigned SEQ_CYCLES_TO_SPIN = 100;
+
+void SeqLock_init(struct SeqLock* lock)
+{
+	lock->sequence = 0;
+
+	TicketLock_init(&lock->writers);
+}
+
+unsigned SeqLock_read_begin(const struct SeqLock* lock)
+{
+	for (unsigned cycle_no = 0; ; ++cycle_no)
+	{
+		unsigned sequence = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+
+		// No writer inside:
+		if ((sequence & 1) == 0) return sequence;
+
+		if (cycle_no < SEQ_CYCLES_TO_SPIN) spin_pause();
+		else                               spin_yield();
+	}
+}
+
+int SeqLock_read_retry(const struct SeqLock* lock, unsigned sequence)
+{
+	// The data loads above must not move below the sequence check:
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+void SeqLock_write_acquire(struct SeqLock* lock)
+{
+	TicketLock_acquire(&lock->writers);
+
+	__atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELAXED);
+
+	// The data stores below must not move above the odd sequence:
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void SeqLock_write_release(struct SeqLock* lock)
+{
+	__atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+
+	TicketLock_release(&lock->writers);
+}
+
+// Word-wise copy with relaxed atomics, byte-wise if the buffers are unaligned:
+static void seqlock_copy(void* to, const void* from, size_t size)
+{
+	if ((((uintptr_t) to | (uintptr_t) from | size) & (sizeof(unsigned long) - 1)) == 0)
+	{
+		unsigned long*       to_words   = (unsigned long*) to;
+		const unsigned long* from_words = (const unsigned long*) from;
+
+		for (size_t word = 0; word < size / sizeof(unsigned long); ++word)
+		{
+			__atomic_store_n(&to_words[word], __atomic_load_n(&from_words[word], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+		}
+
+		return;
+	}
+
+	unsigned char*       to_bytes   = (unsigned char*) to;
+	const unsigned char* from_bytes = (const unsigned char*) from;
+
+	for (size_t byte = 0; byte < size; ++byte)
+	{
+		__atomic_store_n(&to_bytes[byte], __atomic_load_n(&from_bytes[byte], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+	}
+}
+
+void SeqLock_read_copy(const struct SeqLock* lock, void* to, const void* from, size_t size)
+{
+	unsigned sequence;
+
+	do
+	{
+		sequence = SeqLock_read_begin(lock);
+
+		seqlock_copy(to, from, size);
+	}
+	while (SeqLock_read_retry(lock, sequence));
+}
+
+void SeqLock_write_copy(struct SeqLock* lock, void* to, const void* from, size_t size)
+{
+	SeqLock_write_acquire(lock);
+
+	seqlock_copy(to, from, size);
+
+	SeqLock_write_release(lock);
+}
+
+//---------------------
+// Flat-combining lock 
+//---------------------
+// D. Hendler, I. Incze, N. Shavit, M. Tzafrir "Flat Combining and the Synchronization-Parallelism Tradeoff"
+
+const unsigned FC_CYCLES_TO_SPIN = 100;
+
+// Enough slots for a thread per CPU, but at least FC_MIN_SLOTS:
+const unsigned FC_SLOTS_PER_CPU = 2;
+const unsigned FC_MIN_SLOTS     = 16;
+
+enum
+{
+	FC_EMPTY,
+	FC_CLAIMED,
+	FC_PENDING,
+	FC_DONE
+};
+
+// Threads start probing for a free slot at their own one:
+static unsigned FC_next_thread_slot = 0;
+static _Thread_local unsigned FC_thread_slot = (unsigned) -1;
+
+static unsigned FC_get_thread_slot()
+{
+	if (FC_thread_slot == (unsigned) -1)
+	{
+		FC_thread_slot = __atomic_fetch_add(&FC_next_thread_slot, 1, __ATOMIC_RELAXED);
+	}
+
+	return FC_thread_slot;
+}
+
+int FlatCombiningLock_init(struct FlatCombiningLock* lock)
+{
+	TTAS_init(&lock->combiner);
+
+	lock->num_slots = FC_SLOTS_PER_CPU * topology_num_cpus();
+	if (lock->num_slots < FC_MIN_SLOTS) lock->num_slots = FC_MIN_SLOTS;
+
+	lock->slots = aligned_alloc(L1D_LINESIZE, lock->num_slots * sizeof(struct FlatCombiningRequest));
+	if (lock->slots == NULL) return -1;
+
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		lock->slots[slot_i].state = FC_EMPTY;
+	}
+
+	return 0;
+}
+
+// Run every published request, called with the combiner lock held:
+static void FC_combine(struct FlatCombiningLock* lock)
+{
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		struct FlatCombiningRequest* request = &lock->slots[slot_i];
+
+		if (__atomic_load_n(&request->state, __ATOMIC_ACQUIRE) != FC_PENDING) continue;
+
+		request->critical_section(request->argument);
+
+		__atomic_store_n(&request->state, FC_DONE, __ATOMIC_RELEASE);
+	}
+}
+
+void FlatCombiningLock_execute(struct FlatCombiningLock* lock, void (*critical_section)(void*), void* argument)
+{
+	// Claim a free slot:
+	struct FlatCombiningRequest* request;
+
+	for (unsigned probe = 0; ; ++probe)
+	{
+		request = &lock->slots[(FC_get_thread_slot() + probe) % lock->num_slots];
+
+		unsigned expected = FC_EMPTY;
+
+		if (__atomic_load_n(&request->state, __ATOMIC_RELAXED) == FC_EMPTY &&
+		    __atomic_compare_exchange_n(&request->state, &expected, FC_CLAIMED, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+
+		// Every slot is taken, let the combiner drain some of them:
+		if ((probe + 1) % lock->num_slots == 0)
+		{
+			if (probe / lock->num_slots < FC_CYCLES_TO_SPIN) spin_pause();
+			else                                            spin_yield();
+		}
+	}
+
+	// Publish the request:
+	request->critical_section = critical_section;
+	request->argument         = argument;
+
+	__atomic_store_n(&request->state, FC_PENDING, __ATOMIC_RELEASE);
+
+	// Wait for a combiner to run it, or become the combiner:
+	for (unsigned cycle_no = 0; __atomic_load_n(&request->state, __ATOMIC_ACQUIRE) != FC_DONE; ++cycle_no)
+	{
+		if (TTAS_try_acquire(&lock->combiner))
+		{
+			FC_combine(lock);
+
+			TTAS_release(&lock->combiner);
+			continue;
+		}
+
+		if (cycle_no < FC_CYCLES_TO_SPIN) spin_pause();
+		else                              spin_yield();
+	}
+
+	__atomic_store_n(&request->state, FC_EMPTY, __ATOMIC_RELEASE);
+}
+
+void FlatCombiningLock_destroy(struct FlatCombiningLock* lock)
+{
+	free(lock->slots);
+
+	lock->slots     = NULL;
+	lock->num_slots = 0;
+}
+
+//----------------------------------
+// Dedicated-server delegation lock 
+//----------------------------------
+// J.-P. Lozi et al. "Remote Core Locking: Migrating Critical-Section Execution to Improve the Performance of Multithreaded Applications"
+// S. Roghanchi, J. Eriksson, N. Basu "ffwd: delegation is (much) faster than you think"
+
+const unsigned DELEGATION_CYCLES_TO_SPIN = 100;
+
+// Enough slots for a client per CPU, but at least DELEGATION_MIN_SLOTS:
+const unsigned DELEGATION_SLOTS_PER_CPU = 2;
+const unsigned DELEGATION_MIN_SLOTS     = 16;
+
+// Clients start probing for a free slot at their own one:
+static unsigned DELEGATION_next_thread_slot = 0;
+static _Thread_local unsigned DELEGATION_thread_slot = (unsigned) -1;
+
+static unsigned DELEGATION_get_thread_slot()
+{
+	if (DELEGATION_thread_slot == (unsigned) -1)
+	{
+		DELEGATION_thread_slot = __atomic_fetch_add(&DELEGATION_next_thread_slot, 1, __ATOMIC_RELAXED);
+	}
+
+	return DELEGATION_thread_slot;
+}
+
+static void* DelegationLock_serve(void* args)
+{
+	struct DelegationLock* lock = (struct DelegationLock*) args;
+
+	unsigned idle_rounds = 0;
+
+	while (!__atomic_load_n(&lock->stop, __ATOMIC_RELAXED))
+	{
+		// One round-robin batch over all the slots:
+		int served = 0;
+
+		for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+		{
+			struct DelegationRequest* request = &lock->requests[slot_i];
+
+			unsigned long sequence = __atomic_load_n(&request->sequence, __ATOMIC_ACQUIRE);
+			if (sequence == lock->responses[slot_i].sequence) continue;
+
+			request->critical_section(request->argument);
+
+			__atomic_store_n(&lock->responses[slot_i].sequence, sequence, __ATOMIC_RELEASE);
+
+			served = 1;
+		}
+
+		if (served)
+		{
+			idle_rounds = 0;
+			continue;
+		}
+
+		// Nobody is waiting, don't keep the CPU from the clients:
+		if (idle_rounds++ < DELEGATION_CYCLES_TO_SPIN) spin_pause();
+		else                                           spin_yield();
+	}
+
+	return NULL;
+}
+
+// The last online CPU the calling thread may run on, -1 if there is none:
+static int DELEGATION_server_cpu()
+{
+	int online_cpus[TOPOLOGY_MAX_CPUS];
+	unsigned num_online_cpus = topology_online_cpus(online_cpus);
+
+	cpu_set_t allowed;
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return -1;
+
+	for (unsigned cpu_i = num_online_cpus; cpu_i-- > 0; )
+	{
+		if (CPU_ISSET(online_cpus[cpu_i], &allowed)) return online_cpus[cpu_i];
+	}
+
+	return -1;
+}
+
+int DelegationLock_init(struct DelegationLock* lock)
+{
+	size_t num_cpus = topology_num_cpus();
+
+	lock->num_slots = DELEGATION_SLOTS_PER_CPU * num_cpus;
+	if (lock->num_slots < DELEGATION_MIN_SLOTS) lock->num_slots = DELEGATION_MIN_SLOTS;
+
+	lock->requests  = aligned_alloc(L1D_LINESIZE, lock->num_slots * sizeof(struct DelegationRequest));
+	lock->responses = aligned_alloc(L1D_LINESIZE, lock->num_slots * sizeof(struct DelegationResponse));
+	if (lock->requests == NULL || lock->responses == NULL)
+	{
+		free(lock->requests);
+		free(lock->responses);
+		return -1;
+	}
+
+	for (unsigned slot_i = 0; slot_i < lock->num_slots; ++slot_i)
+	{
+		lock->requests [slot_i].sequence = 0;
+		lock->requests [slot_i].claimed  = 0;
+		lock->responses[slot_i].sequence = 0;
+	}
+
+	lock->stop = 0;
+
+	if (pthread_create(&lock->server, NULL, DelegationLock_serve, lock) != 0)
+	{
+		free(lock->requests);
+		free(lock->responses);
+		return -1;
+	}
+
+	// The server just runs unpinned if it can't be pinned:
+	lock->server_cpu = DELEGATION_server_cpu();
+
+	if (lock->server_cpu >= 0)
+	{
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(lock->server_cpu, &cpu_set);
+
+		if (pthread_setaffinity_np(lock->server, sizeof(cpu_set), &cpu_set) != 0) lock->server_cpu = -1;
+	}
+
+	return 0;
+}
+
+void DelegationLock_execute(struct DelegationLock* lock, void (*critical_section)(void*), void* argument)
+{
+	// Claim a free slot:
+	unsigned slot_i;
+
+	for (unsigned probe = 0; ; ++probe)
+	{
+		slot_i = (DELEGATION_get_thread_slot() + probe) % lock->num_slots;
+
+		if (!__atomic_load_n(&lock->requests[slot_i].claimed, __ATOMIC_RELAXED) &&
+		    !__atomic_test_and_set(&lock->requests[slot_i].claimed, __ATOMIC_ACQUIRE))
+		{
+			break;
+		}
+
+		// Every slot has a client, wait for the server to answer some:
+		if ((probe + 1) % lock->num_slots == 0)
+		{
+			if (probe / lock->num_slots < DELEGATION_CYCLES_TO_SPIN) spin_pause();
+			else                                                    spin_yield();
+		}
+	}
+
+	struct DelegationRequest*  request  = &lock->requests [slot_i];
+	struct DelegationResponse* response = &lock->responses[slot_i];
+
+	// Post the request:
+	unsigned long sequence = request->sequence + 1;
+
+	request->critical_section = critical_section;
+	request->argument         = argument;
+
+	__atomic_store_n(&request->sequence, sequence, __ATOMIC_RELEASE);
+
+	// Spin on the response line only:
+	for (unsigned cycle_no = 0; __atomic_load_n(&response->sequence, __ATOMIC_ACQUIRE) != sequence; ++cycle_no)
+	{
+		if (cycle_no < DELEGATION_CYCLES_TO_SPIN) spin_pause();
+		else                                      spin_yield();
+	}
+
+	__atomic_clear(&request->claimed, __ATOMIC_RELEASE);
+}
+
+void DelegationLock_destroy(struct DelegationLock* lock)
+{
+	__atomic_store_n(&lock->stop, 1, __ATOMIC_RELAXED);
+
+	pthread_join(lock->server, NULL);
+
+	free(lock->requests);
+	free(lock->responses);
+
+	lock->requests  = NULL;
+	lock->responses = NULL;
+	lock->num_slots = 0;
 }
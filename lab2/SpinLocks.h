@@ -2,6 +2,12 @@
 #ifndef SPIN_LOCKS_HPP_INCLUDED
 #define SPIN_LOCKS_HPP_INCLUDED
 
+#include "LockStats.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
 //------------------
 // Asm instructions 
 //------------------
@@ -28,6 +34,39 @@ and nothing from the code ahead will be moved after the pause, actually it may e
 Which look as something what the author probably did want
 */
 
+//------------
+// Cache line 
+//------------
+
+// The Makefile passes the actual L1D line size:
+#ifndef L1D_LINESIZE
+#define L1D_LINESIZE 64
+#endif
+
+#define CACHE_LINE_ALIGNED __attribute__((aligned(L1D_LINESIZE)))
+
+//-------------------
+// Timed acquisition 
+//-------------------
+
+// *_try_acquire() makes a single attempt and returns 1 if the lock is taken, 0 otherwise.
+// *_acquire_for() gives up after timeout_ns nanoseconds and returns 0.
+// Queue locks either abandon their queue node on timeout (CLH) or don't join the queue
+// until the lock is free (ticket locks), so a timed-out waiter never blocks the others.
+
+//----------------
+// Backoff jitter 
+//----------------
+
+// TAS and TTAS add a random value in [0, bound) to every backoff sleep.
+// The source is fast_random_jitter() unless a benchmark swaps it:
+typedef uint32_t (*BackoffJitter)(uint32_t bound);
+
+extern BackoffJitter spin_backoff_jitter;
+
+uint32_t fast_random_jitter(uint32_t bound);
+uint32_t libc_rand_jitter  (uint32_t bound);
+
 //------------------------------------------------------------------
 // TAS lock
 //------------------------------------------------------------------
@@ -39,11 +78,15 @@ Which look as something what the author probably did want
 struct TAS_Lock
 {
 	volatile char lock_taken;
+
+	LOCK_STATS_FIELDS
 };
 
-void TAS_init   (struct TAS_Lock* lock);
-void TAS_acquire(struct TAS_Lock* lock);
-void TAS_release(struct TAS_Lock* lock);
+void TAS_init       (struct TAS_Lock* lock);
+void TAS_acquire    (struct TAS_Lock* lock);
+int  TAS_try_acquire(struct TAS_Lock* lock);
+int  TAS_acquire_for(struct TAS_Lock* lock, unsigned long long timeout_ns);
+void TAS_release    (struct TAS_Lock* lock);
 
 //------------------------------------------------------------------
 // TTAS lock 
@@ -57,11 +100,15 @@ void TAS_release(struct TAS_Lock* lock);
 struct TTAS_Lock
 {
 	volatile char lock_taken;
+
+	LOCK_STATS_FIELDS
 };
 
-void TTAS_init   (struct TTAS_Lock* lock);
-void TTAS_acquire(struct TTAS_Lock* lock);
-void TTAS_release(struct TTAS_Lock* lock);
+void TTAS_init       (struct TTAS_Lock* lock);
+void TTAS_acquire    (struct TTAS_Lock* lock);
+int  TTAS_try_acquire(struct TTAS_Lock* lock);
+int  TTAS_acquire_for(struct TTAS_Lock* lock, unsigned long long timeout_ns);
+void TTAS_release    (struct TTAS_Lock* lock);
 
 //------------------------------------------------------------------
 // Ticket lock 
@@ -69,17 +116,596 @@ void TTAS_release(struct TTAS_Lock* lock);
 // Optimizations:
 // - First-in first-out fairness
 // - Assembler "pause" instruction for power-effective busy-waiting
-// - Schedule the next thread if the lock is taken
+// - Proportional backoff: a waiter lets its queue distance times
+//   the average critical section (capped) pass before every read of
+//   the lock line, so only the next-in-line thread keeps polling it
+// - Long backoffs and a long wait of the next-in-line thread
+//   schedule the next thread instead of spinning
+// - An uncontended acquisition is a single fetch-and-add, only
+//   a holder that waited times its critical section
 //------------------------------------------------------------------
 
 struct TicketLock
 {
 	volatile short next_ticket;
 	volatile short now_serving;
+
+	// Critical section timing in TSC cycles (written by the holder),
+	// acquired_at stays 0 on the uncontended fast path:
+	unsigned long long acquired_at;
+	volatile unsigned hold_cycles;
+
+	LOCK_STATS_FIELDS
+};
+
+void TicketLock_init       (struct TicketLock* lock);
+void TicketLock_acquire    (struct TicketLock* lock);
+int  TicketLock_try_acquire(struct TicketLock* lock);
+int  TicketLock_acquire_for(struct TicketLock* lock, unsigned long long timeout_ns);
+void TicketLock_release    (struct TicketLock* lock);
+
+// Contended part of an acquisition that took the ticket but wasn't served right away:
+void TicketLock_wait_for_turn(struct TicketLock* lock, short ticket);
+
+//------------------------------------------------------------------
+// Cache-line-padded lock layouts
+//------------------------------------------------------------------
+// Optimizations:
+// - Every padded lock owns a whole cache line, so neighbouring locks
+//   and data never share it (no false sharing)
+// - Split ticket lock: arriving threads write next_ticket, while
+//   the releasing thread writes now_serving on a separate line
+//
+// Padded locks are used with the regular functions:
+//     TAS_acquire(&padded_lock.lock);
+//------------------------------------------------------------------
+
+struct TAS_PaddedLock    { struct TAS_Lock   lock; } CACHE_LINE_ALIGNED;
+struct TTAS_PaddedLock   { struct TTAS_Lock  lock; } CACHE_LINE_ALIGNED;
+struct TicketPaddedLock  { struct TicketLock lock; } CACHE_LINE_ALIGNED;
+
+struct SplitTicketLock
+{
+	// Written by arriving threads:
+	volatile short next_ticket CACHE_LINE_ALIGNED;
+
+	// Written by the releasing thread and polled by the waiters:
+	volatile short now_serving CACHE_LINE_ALIGNED;
+	volatile unsigned hold_cycles;
+
+	LOCK_STATS_FIELDS
+
+	// Private to the lock holder:
+	unsigned long long acquired_at CACHE_LINE_ALIGNED;
+};
+
+void SplitTicketLock_init       (struct SplitTicketLock* lock);
+void SplitTicketLock_acquire    (struct SplitTicketLock* lock);
+int  SplitTicketLock_try_acquire(struct SplitTicketLock* lock);
+int  SplitTicketLock_acquire_for(struct SplitTicketLock* lock, unsigned long long timeout_ns);
+void SplitTicketLock_release    (struct SplitTicketLock* lock);
+
+void SplitTicketLock_wait_for_turn(struct SplitTicketLock* lock, short ticket);
+
+//------------------------------------------------------------------
+// CLH lock
+//------------------------------------------------------------------
+// Optimizations:
+// - First-in first-out fairness
+// - Every waiter spins on its predecessor's node (local spinning)
+// - A single atomic exchange per lock acquisition
+// - Queue nodes are recycled through a thread-local cache,
+//   so the acquire path does no allocation in steady state
+// - Timed-out waiters abandon their nodes, successors skip them
+// - Schedule the next thread if the lock is taken for too long
+//------------------------------------------------------------------
+
+struct CLH_Node
+{
+	// CLH_WAITING, CLH_AVAILABLE or the predecessor of a timed-out waiter:
+	struct CLH_Node* volatile state;
+
+	// Link in the thread-local cache of free nodes:
+	struct CLH_Node* next_free;
+
+	// Release time, published by the holder along with CLH_AVAILABLE:
+	LOCK_STATS_FIELDS
+} CACHE_LINE_ALIGNED;
+
+#define CLH_AVAILABLE ((struct CLH_Node*) 0)
+#define CLH_WAITING   ((struct CLH_Node*) 1)
+
+struct CLH_Lock
+{
+	struct CLH_Node* volatile tail;
+
+	// Owned by the current lock holder:
+	struct CLH_Node* holder_node;
+};
+
+int  CLH_init       (struct CLH_Lock* lock);
+void CLH_acquire    (struct CLH_Lock* lock);
+int  CLH_try_acquire(struct CLH_Lock* lock);
+int  CLH_acquire_for(struct CLH_Lock* lock, unsigned long long timeout_ns);
+void CLH_release    (struct CLH_Lock* lock);
+void CLH_destroy    (struct CLH_Lock* lock);
+
+//------------------------------------------------------------------
+// Anderson array lock
+//------------------------------------------------------------------
+// Optimizations:
+// - First-in first-out fairness
+// - A fetch-and-add ticket picks the waiter's slot in an array of
+//   cache-line-padded flags, every waiter spins on its own slot
+//   instead of a shared now_serving counter
+// - The releasing thread writes only the next waiter's slot
+// - No per-thread queue nodes
+// - Schedule the next thread if the lock is taken for too long
+//
+// The capacity is rounded up to a power of two. Slots hold the ticket
+// they grant, so more waiters than slots only share slots and are
+// still served in order.
+//------------------------------------------------------------------
+
+struct AndersonSlot
+{
+	// Ticket allowed to take the lock:
+	volatile unsigned grant;
+
+	// Release time, published by the holder along with the grant:
+	LOCK_STATS_FIELDS
+} CACHE_LINE_ALIGNED;
+
+struct AndersonLock
+{
+	volatile unsigned next_ticket;
+
+	// Owned by the current lock holder:
+	unsigned holder_ticket;
+
+	unsigned num_slots;
+	struct AndersonSlot* slots;
+};
+
+// One slot per online CPU:
+#define ANDERSON_DEFAULT_CAPACITY 0
+
+int  AndersonLock_init       (struct AndersonLock* lock, unsigned capacity);
+void AndersonLock_acquire    (struct AndersonLock* lock);
+int  AndersonLock_try_acquire(struct AndersonLock* lock);
+int  AndersonLock_acquire_for(struct AndersonLock* lock, unsigned long long timeout_ns);
+void AndersonLock_release    (struct AndersonLock* lock);
+void AndersonLock_destroy    (struct AndersonLock* lock);
+
+//------------------------------------------------------------------
+// Time-published queue lock (MCS-TP)
+//------------------------------------------------------------------
+// Optimizations:
+// - First-in first-out among running waiters, every waiter spins
+//   on its own queue node (local spinning)
+// - Waiters publish a TSC heartbeat in their node, the releasing
+//   thread skips a waiter whose heartbeat is older than
+//   TP_STALE_CYCLES, so a preempted waiter doesn't stall the queue;
+//   a skipped waiter rejoins at the tail once it runs again
+// - Waiters yield right away if the holder has held the lock for
+//   longer than TP_STALE_CYCLES (the holder is likely preempted)
+//   (the acquisition time they poll has a cache line of its own)
+// - Queue nodes are recycled through a thread-local cache
+//------------------------------------------------------------------
+
+struct TimePublishedNode
+{
+	// TP_WAITING, TP_GRANTED or TP_REMOVED:
+	volatile unsigned state;
+
+	// Last TSC reading of the spinning waiter:
+	volatile unsigned long long heartbeat;
+
+	struct TimePublishedNode* volatile next;
+
+	// Link in the thread-local cache of free nodes:
+	struct TimePublishedNode* next_free;
+
+	// Release time, published by the holder along with TP_GRANTED:
+	LOCK_STATS_FIELDS
+} CACHE_LINE_ALIGNED;
+
+struct TimePublishedLock
+{
+	struct TimePublishedNode* volatile tail;
+
+	// Owned by the current lock holder:
+	struct TimePublishedNode* holder_node;
+
+	// Polled by every waiter, so the tail swaps of arriving threads don't invalidate it:
+	volatile unsigned long long acquired_at CACHE_LINE_ALIGNED;
+};
+
+void TimePublishedLock_init       (struct TimePublishedLock* lock);
+void TimePublishedLock_acquire    (struct TimePublishedLock* lock);
+int  TimePublishedLock_try_acquire(struct TimePublishedLock* lock);
+void TimePublishedLock_release    (struct TimePublishedLock* lock);
+
+//------------------------------------------------------------------
+// Cohort lock (NUMA-aware)
+//------------------------------------------------------------------
+// Optimizations:
+// - Per-NUMA-node local ticket lock under a global ticket lock
+// - The global lock is handed over inside a node up to
+//   COHORT_MAX_LOCAL_HANDOFFS times, so the lock line and the data
+//   it protects stay on one socket
+// - First-in first-out fairness within a node
+//------------------------------------------------------------------
+
+struct CohortLocalLock
+{
+	struct TicketLock lock;
+
+	// The node's cohort owns the global lock:
+	volatile char global_taken;
+
+	// Consecutive handoffs inside the node:
+	unsigned num_handoffs;
+} CACHE_LINE_ALIGNED;
+
+struct CohortLock
+{
+	struct TicketLock global;
+
+	unsigned num_nodes;
+	struct CohortLocalLock* local;
+
+	// Owned by the current lock holder:
+	struct CohortLocalLock* holder_local;
+};
+
+int  CohortLock_init       (struct CohortLock* lock);
+void CohortLock_acquire    (struct CohortLock* lock);
+int  CohortLock_try_acquire(struct CohortLock* lock);
+int  CohortLock_acquire_for(struct CohortLock* lock, unsigned long long timeout_ns);
+void CohortLock_release    (struct CohortLock* lock);
+void CohortLock_destroy    (struct CohortLock* lock);
+
+//------------------------------------------------------------------
+// Hybrid lock (spin-then-park)
+//------------------------------------------------------------------
+// Optimizations:
+// - Spins for a bounded budget, then parks on a Linux futex
+//   instead of sleeping or yielding for a guessed time
+// - Waiter counting: the release path makes no system call
+//   if nobody is parked
+//------------------------------------------------------------------
+
+struct HybridLock
+{
+	volatile int lock_taken;
+	volatile int num_waiters;
+
+	LOCK_STATS_FIELDS
+};
+
+void HybridLock_init       (struct HybridLock* lock);
+void HybridLock_acquire    (struct HybridLock* lock);
+int  HybridLock_try_acquire(struct HybridLock* lock);
+int  HybridLock_acquire_for(struct HybridLock* lock, unsigned long long timeout_ns);
+void HybridLock_release    (struct HybridLock* lock);
+
+//------------------------------------------------------------------
+// Biased lock (owner-affine)
+//------------------------------------------------------------------
+// Optimizations:
+// - The lock is biased to the first thread that takes it, the owner
+//   acquires and releases with plain loads and stores: no atomic
+//   read-modify-write and no fence
+// - Other threads serialize on a TTAS lock, then revoke the bias for
+//   one critical section with an asymmetric Dekker handshake:
+//   membarrier() forces a full fence on the owner's CPU instead of
+//   the owner paying for one on every acquisition
+// - Once other threads take more than 1/BIASED_LOCK_REVOKE_RATIO of
+//   the acquisitions, the bias is revoked for good and the lock
+//   becomes a plain TTAS lock
+// - Without membarrier() (old kernels) the owner falls back to mfence
+//------------------------------------------------------------------
+
+struct BiasedLock
+{
+	// Written by the owner only:
+	volatile unsigned owner_busy CACHE_LINE_ALIGNED;
+	volatile unsigned long long num_owner_acquisitions;
+
+	// Owner's thread token, 0 before the first acquisition:
+	volatile uintptr_t bias_owner;
+
+	// Written by the other threads only, under the fallback lock:
+	volatile unsigned revoke_pending CACHE_LINE_ALIGNED;
+	unsigned holder_mode;
+	unsigned long long num_handshakes;
+
+	// Counts the instrumented waits of the slow path:
+	struct TTAS_Lock fallback;
+};
+
+void BiasedLock_init       (struct BiasedLock* lock);
+void BiasedLock_acquire    (struct BiasedLock* lock);
+int  BiasedLock_try_acquire(struct BiasedLock* lock);
+void BiasedLock_release    (struct BiasedLock* lock);
+
+//------------------------------------------------------------------
+// Adaptive lock (self-tuning spin-then-park)
+//------------------------------------------------------------------
+// Optimizations:
+// - Every lock instance keeps moving averages of its hold time and
+//   of its acquisition wait time (TSC cycles), kept on the lock line
+//   the holder writes anyway
+// - Spin phase: waiters poll for a few average hold times, so short
+//   critical sections are handed over without leaving the CPU
+// - Backoff phase: waiters poll once per average hold time instead
+//   of hammering the lock line, or yield if the holder is running
+//   late (likely preempted)
+// - Park phase: waiters sleep on a futex once they have waited for
+//   longer than a park/wake round trip costs, or right away if the
+//   average wait says they will
+//------------------------------------------------------------------
+
+struct AdaptiveLock
+{
+	volatile int lock_taken;
+	volatile int num_waiters;
+
+	// Moving averages, written by the lock holder:
+	volatile unsigned hold_cycles;
+	volatile unsigned wait_cycles;
+
+	// Written by the lock holder, waiters use it to tell a preempted holder:
+	volatile unsigned long long acquired_at;
+
+	LOCK_STATS_FIELDS
+};
+
+void AdaptiveLock_init       (struct AdaptiveLock* lock);
+void AdaptiveLock_acquire    (struct AdaptiveLock* lock);
+int  AdaptiveLock_try_acquire(struct AdaptiveLock* lock);
+int  AdaptiveLock_acquire_for(struct AdaptiveLock* lock, unsigned long long timeout_ns);
+void AdaptiveLock_release    (struct AdaptiveLock* lock);
+
+//------------------------------------------------------------------
+// Reader-writer lock (centralized counter)
+//------------------------------------------------------------------
+// Optimizations:
+// - Readers enter concurrently with one CAS on a shared counter
+// - Writer preference: a waiting writer stops new readers
+// - Schedule the next thread if the lock is taken for too long
+//------------------------------------------------------------------
+
+struct RWLock
+{
+	// Bit 0 - writer inside, bit 1 - writer waiting, the rest - readers:
+	volatile unsigned state;
+};
+
+void RWLock_init             (struct RWLock* lock);
+void RWLock_read_acquire     (struct RWLock* lock);
+void RWLock_read_release     (struct RWLock* lock);
+void RWLock_write_acquire    (struct RWLock* lock);
+int  RWLock_write_try_acquire(struct RWLock* lock);
+void RWLock_write_release    (struct RWLock* lock);
+
+//------------------------------------------------------------------
+// Phase-fair ticket reader-writer lock
+//------------------------------------------------------------------
+// Optimizations:
+// - Reader and writer phases alternate, so neither side starves:
+//   a reader waits for at most one writer and vice versa
+// - First-in first-out order among writers
+// - Readers take a single fetch-and-add to enter and to leave
+//------------------------------------------------------------------
+
+struct PhaseFairRWLock
+{
+	// Reader entry/exit counters (low byte holds the writer bits):
+	volatile unsigned reader_in;
+	volatile unsigned reader_out;
+
+	// Writer tickets:
+	volatile unsigned writer_in;
+	volatile unsigned writer_out;
+};
+
+void PhaseFairRWLock_init             (struct PhaseFairRWLock* lock);
+void PhaseFairRWLock_read_acquire     (struct PhaseFairRWLock* lock);
+void PhaseFairRWLock_read_release     (struct PhaseFairRWLock* lock);
+void PhaseFairRWLock_write_acquire    (struct PhaseFairRWLock* lock);
+int  PhaseFairRWLock_write_try_acquire(struct PhaseFairRWLock* lock);
+void PhaseFairRWLock_write_release    (struct PhaseFairRWLock* lock);
+
+//------------------------------------------------------------------
+// Distributed reader-writer lock (per-core reader indicators)
+//------------------------------------------------------------------
+// Optimizations:
+// - Readers only touch the cache-line-padded counter of the CPU
+//   they run on (sched_getcpu()), so read acquisitions don't
+//   bounce a shared line
+// - A reader that migrated leaves through its new CPU's counter,
+//   writers wait for the sum over all counters to drop to zero
+// - Writers are serialized by a ticket lock and wait
+//   for every reader counter to drain
+// - Writer preference: an active writer stops new readers
+//------------------------------------------------------------------
+
+struct DistributedRWReaderSlot
+{
+	volatile unsigned readers;
+} CACHE_LINE_ALIGNED;
+
+struct DistributedRWLock
+{
+	struct TicketLock writers;
+
+	volatile char writer_active;
+
+	unsigned num_slots;
+	struct DistributedRWReaderSlot* slots;
+};
+
+int  DistributedRWLock_init             (struct DistributedRWLock* lock);
+void DistributedRWLock_read_acquire     (struct DistributedRWLock* lock);
+void DistributedRWLock_read_release     (struct DistributedRWLock* lock);
+void DistributedRWLock_write_acquire    (struct DistributedRWLock* lock);
+int  DistributedRWLock_write_try_acquire(struct DistributedRWLock* lock);
+void DistributedRWLock_write_release    (struct DistributedRWLock* lock);
+void DistributedRWLock_destroy          (struct DistributedRWLock* lock);
+
+//------------------------------------------------------------------
+// Cache-line-padded layouts of the other locks
+//------------------------------------------------------------------
+// As TAS_PaddedLock, the part every thread writes (tail, ticket,
+// lock word or reader counter) gets a line of its own, so does the
+// combiner lock of FlatCombiningPaddedLock below. Queue nodes, array
+// slots, cohort locals and reader indicators are padded already.
+// No wrapper, padded by design:
+// - BiasedLock and SplitTicketLock
+// - DelegationLock, its head is written only by init and destroy
+//------------------------------------------------------------------
+
+struct CLH_PaddedLock          { struct CLH_Lock          lock; } CACHE_LINE_ALIGNED;
+struct AndersonPaddedLock      { struct AndersonLock      lock; } CACHE_LINE_ALIGNED;
+struct TimePublishedPaddedLock { struct TimePublishedLock lock; } CACHE_LINE_ALIGNED;
+struct CohortPaddedLock        { struct CohortLock        lock; } CACHE_LINE_ALIGNED;
+struct HybridPaddedLock        { struct HybridLock        lock; } CACHE_LINE_ALIGNED;
+struct AdaptivePaddedLock      { struct AdaptiveLock      lock; } CACHE_LINE_ALIGNED;
+struct RWPaddedLock            { struct RWLock            lock; } CACHE_LINE_ALIGNED;
+struct PhaseFairRWPaddedLock   { struct PhaseFairRWLock   lock; } CACHE_LINE_ALIGNED;
+struct DistributedRWPaddedLock { struct DistributedRWLock lock; } CACHE_LINE_ALIGNED;
+
+//------------------------------------------------------------------
+// Sequence lock (seqlock)
+//------------------------------------------------------------------
+// Optimizations:
+// - Readers never write shared memory: they copy the data out
+//   optimistically and retry if a writer changed the sequence
+// - Writers are serialized by a ticket lock and never wait for readers
+// - Data is copied with relaxed atomic word accesses, so a torn
+//   copy is only ever discarded, never a data race
+//
+// Usage:
+//     SEQLOCK_WRITE(&lock, &shared_config, &new_config);
+//     SEQLOCK_READ (&lock, &local_config, &shared_config);
+//------------------------------------------------------------------
+
+struct SeqLock
+{
+	// Odd while a writer is inside:
+	volatile unsigned sequence;
+
+	struct TicketLock writers;
+};
+
+void     SeqLock_init         (struct SeqLock* lock);
+unsigned SeqLock_read_begin   (const struct SeqLock* lock);
+int      SeqLock_read_retry   (const struct SeqLock* lock, unsigned sequence);
+void     SeqLock_write_acquire(struct SeqLock* lock);
+void     SeqLock_write_release(struct SeqLock* lock);
+
+// Consistent copy of size bytes of the protected data:
+void SeqLock_read_copy (const struct SeqLock* lock, void* to, const void* from, size_t size);
+void SeqLock_write_copy(struct SeqLock* lock,       void* to, const void* from, size_t size);
+
+// Typed front-ends, both pointers must point to the same type:
+#define SEQLOCK_READ(lock, to, from)                                 \
+	do                                                               \
+	{                                                                \
+		(void) sizeof((to) == (from));                               \
+		SeqLock_read_copy((lock), (to), (from), sizeof(*(to)));      \
+	} while (0)
+
+#define SEQLOCK_WRITE(lock, to, from)                                \
+	do                                                               \
+	{                                                                \
+		(void) sizeof((to) == (from));                               \
+		SeqLock_write_copy((lock), (to), (from), sizeof(*(to)));     \
+	} while (0)
+
+//------------------------------------------------------------------
+// Flat-combining lock
+//------------------------------------------------------------------
+// Optimizations:
+// - Threads publish their critical sections into request slots,
+//   whoever takes the combiner lock runs every pending request,
+//   so the data stays in the cache of one core
+// - Waiters spin on their own cache-line-padded slot
+// - A waiter checks the combiner lock before writing it
+//------------------------------------------------------------------
+
+struct FlatCombiningRequest
+{
+	void (*critical_section)(void* argument);
+	void* argument;
+
+	// FC_EMPTY, FC_CLAIMED, FC_PENDING or FC_DONE:
+	volatile unsigned state;
+} CACHE_LINE_ALIGNED;
+
+struct FlatCombiningLock
+{
+	struct TTAS_Lock combiner;
+
+	unsigned num_slots;
+	struct FlatCombiningRequest* slots;
+};
+
+int  FlatCombiningLock_init   (struct FlatCombiningLock* lock);
+void FlatCombiningLock_execute(struct FlatCombiningLock* lock, void (*critical_section)(void*), void* argument);
+void FlatCombiningLock_destroy(struct FlatCombiningLock* lock);
+
+struct FlatCombiningPaddedLock { struct FlatCombiningLock lock; } CACHE_LINE_ALIGNED;
+
+//------------------------------------------------------------------
+// Dedicated-server delegation lock (RCL/ffwd-style)
+//------------------------------------------------------------------
+// Optimizations:
+// - One pinned server thread runs every critical section, so the
+//   protected data never leaves its cache and no lock word bounces
+// - A client writes its request line and spins on its own response
+//   line, which only the server writes
+// - The server serves all pending requests in round-robin batches
+//   and never takes a lock
+//
+// The server is pinned to the last online CPU the process may run
+// on, clients should keep off that CPU.
+//------------------------------------------------------------------
+
+struct DelegationRequest
+{
+	void (*critical_section)(void* argument);
+	void* argument;
+
+	// A new request once it differs from the response sequence:
+	volatile unsigned long sequence;
+
+	// The slot has a client:
+	volatile char claimed;
+} CACHE_LINE_ALIGNED;
+
+struct DelegationResponse
+{
+	volatile unsigned long sequence;
+} CACHE_LINE_ALIGNED;
+
+struct DelegationLock
+{
+	unsigned num_slots;
+	struct DelegationRequest*  requests;
+	struct DelegationResponse* responses;
+
+	pthread_t server;
+	volatile char stop;
+
+	// CPU the server is pinned to, -1 if it runs unpinned:
+	int server_cpu;
 };
 
-void TicketLock_init   (struct TicketLock* lock);
-void TicketLock_acquire(struct TicketLock* lock);
-void TicketLock_release(struct TicketLock* lock);
+int  DelegationLock_init   (struct DelegationLock* lock);
+void DelegationLock_execute(struct DelegationLock* lock, void (*critical_section)(void*), void* argument);
+void DelegationLock_destroy(struct DelegationLock* lock);
 
 #endif // SPIN_LOCKS_HPP_INCLUDED
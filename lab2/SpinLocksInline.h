@@ -0,0 +1,193 @@
+#ifndef SPIN_LOCKS_INLINE_HPP_INCLUDED
+#define SPIN_LOCKS_INLINE_HPP_INCLUDED
+
+#include "SpinLocks.h"
+#include "LockInterface.h"
+#include "LockStats.h"
+
+#include <x86intrin.h>
+
+//------------------------------------------------------------------
+// Inline lock front-end
+//------------------------------------------------------------------
+// Header-only fast paths of the TAS, TTAS and ticket locks:
+//     struct TicketLock lock;
+//     TicketLock_init(&lock);
+//     spin_acquire(&lock);
+//     spin_release(&lock);
+// - An uncontended acquisition and every release compile into the
+//   caller: no function pointer, no call, no spilled registers
+// - Only a contended acquisition calls out of line into SpinLocks.c,
+//   which spins and backs off as usual
+// - The ticket fast path is a single fetch-and-add and a load of
+//   now_serving, no TSC read: only a holder that waited times its
+//   critical section, and its release updates the average only if
+//   somebody waits behind it
+// - _Generic picks the lock by its pointer type, a struct Lock*
+//   goes through the operation table of LockInterface.h
+// - The instrumented build (-D LOCK_STATS) calls the out-of-line
+//   functions only, so every counter still counts
+//
+// Build the caller with optimizations (inline_lock_test always is),
+// -O0 inlines nothing. spin_lock_test calls every lock through its
+// struct Lock operation table and doesn't use this front-end.
+//------------------------------------------------------------------
+
+//-------------------------------
+// Ticket helpers (SpinLocks.c too)
+//-------------------------------
+
+static const unsigned TICKET_HOLD_AVERAGING_SHIFT = 3;
+
+// A ticket is taken only if it is served right away, so the queue never holds abandoned tickets.
+// now_serving never overtakes next_ticket, so it still equals the ticket at the moment of the CAS:
+static inline int ticket_try_take_turn(volatile short* next_ticket, volatile short* now_serving)
+{
+	short serving = __atomic_load_n(now_serving, __ATOMIC_ACQUIRE);
+	short ticket  = serving;
+
+	int taken = __atomic_compare_exchange_n(next_ticket, &ticket, (short) (serving + 1), 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+
+	if (!taken) LOCK_STATS_ADD(num_failed_atomics, 1);
+
+	return taken;
+}
+
+// acquired_at is 0 if the holder took the uncontended fast path:
+static inline void ticket_pass_turn(volatile short* next_ticket, volatile short* now_serving,
+                                    volatile unsigned* hold_cycles, unsigned long long* acquired_at)
+{
+	// Only the holder writes now_serving:
+	const short serving = *now_serving;
+
+	if (*acquired_at != 0)
+	{
+		// Update the moving average of the critical section length, only waiters use it:
+		if (__atomic_load_n(next_ticket, __ATOMIC_RELAXED) != (short) (serving + 1))
+		{
+			long long cur_hold_cycles = __rdtsc() - *acquired_at;
+			long long average         = *hold_cycles;
+
+			__atomic_store_n(hold_cycles, average + ((cur_hold_cycles - average) >> TICKET_HOLD_AVERAGING_SHIFT), __ATOMIC_RELAXED);
+		}
+
+		*acquired_at = 0;
+	}
+
+	__atomic_store_n(now_serving, (short) (serving + 1), __ATOMIC_RELEASE);
+}
+
+//----------
+// TAS lock
+//----------
+
+static inline int TAS_try_acquire_inline(struct TAS_Lock* lock)
+{
+	return !__atomic_test_and_set(&lock->lock_taken, __ATOMIC_ACQUIRE);
+}
+
+static inline void TAS_acquire_inline(struct TAS_Lock* lock)
+{
+	if (!TAS_try_acquire_inline(lock)) TAS_acquire(lock);
+}
+
+static inline void TAS_release_inline(struct TAS_Lock* lock)
+{
+	__atomic_clear(&lock->lock_taken, __ATOMIC_RELEASE);
+}
+
+//-----------
+// TTAS lock
+//-----------
+
+static inline int TTAS_try_acquire_inline(struct TTAS_Lock* lock)
+{
+	// Don't write the line if the lock is taken anyway:
+	return !__atomic_load_n(&lock->lock_taken, __ATOMIC_RELAXED) &&
+	       !__atomic_test_and_set(&lock->lock_taken, __ATOMIC_ACQUIRE);
+}
+
+static inline void TTAS_acquire_inline(struct TTAS_Lock* lock)
+{
+	if (!TTAS_try_acquire_inline(lock)) TTAS_acquire(lock);
+}
+
+static inline void TTAS_release_inline(struct TTAS_Lock* lock)
+{
+	__atomic_clear(&lock->lock_taken, __ATOMIC_RELEASE);
+}
+
+//--------------
+// Ticket locks
+//--------------
+
+static inline int TicketLock_try_acquire_inline(struct TicketLock* lock)
+{
+	return ticket_try_take_turn(&lock->next_ticket, &lock->now_serving);
+}
+
+// Take a ticket, wait in the queue out of line only if it isn't served right away:
+static inline void TicketLock_acquire_inline(struct TicketLock* lock)
+{
+	const short ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_ACQUIRE);
+
+	if (ticket != __atomic_load_n(&lock->now_serving, __ATOMIC_ACQUIRE)) TicketLock_wait_for_turn(lock, ticket);
+}
+
+static inline void TicketLock_release_inline(struct TicketLock* lock)
+{
+	ticket_pass_turn(&lock->next_ticket, &lock->now_serving, &lock->hold_cycles, &lock->acquired_at);
+}
+
+static inline int SplitTicketLock_try_acquire_inline(struct SplitTicketLock* lock)
+{
+	return ticket_try_take_turn(&lock->next_ticket, &lock->now_serving);
+}
+
+static inline void SplitTicketLock_acquire_inline(struct SplitTicketLock* lock)
+{
+	const short ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_ACQUIRE);
+
+	if (ticket != __atomic_load_n(&lock->now_serving, __ATOMIC_ACQUIRE)) SplitTicketLock_wait_for_turn(lock, ticket);
+}
+
+static inline void SplitTicketLock_release_inline(struct SplitTicketLock* lock)
+{
+	ticket_pass_turn(&lock->next_ticket, &lock->now_serving, &lock->hold_cycles, &lock->acquired_at);
+}
+
+//---------------------
+// Generic front-end
+//---------------------
+
+#ifdef LOCK_STATS
+#define SPIN_INLINE(inline_function, function) function
+#else
+#define SPIN_INLINE(inline_function, function) inline_function
+#endif
+
+#define spin_acquire(lock)                                                                             \
+	_Generic((lock),                                                                                   \
+		struct TAS_Lock*:        SPIN_INLINE(TAS_acquire_inline,             TAS_acquire),             \
+		struct TTAS_Lock*:       SPIN_INLINE(TTAS_acquire_inline,            TTAS_acquire),            \
+		struct TicketLock*:      SPIN_INLINE(TicketLock_acquire_inline,      TicketLock_acquire),      \
+		struct SplitTicketLock*: SPIN_INLINE(SplitTicketLock_acquire_inline, SplitTicketLock_acquire), \
+		struct Lock*:            lock_acquire)(lock)
+
+#define spin_try_acquire(lock)                                                                                 \
+	_Generic((lock),                                                                                           \
+		struct TAS_Lock*:        SPIN_INLINE(TAS_try_acquire_inline,             TAS_try_acquire),             \
+		struct TTAS_Lock*:       SPIN_INLINE(TTAS_try_acquire_inline,            TTAS_try_acquire),            \
+		struct TicketLock*:      SPIN_INLINE(TicketLock_try_acquire_inline,      TicketLock_try_acquire),      \
+		struct SplitTicketLock*: SPIN_INLINE(SplitTicketLock_try_acquire_inline, SplitTicketLock_try_acquire), \
+		struct Lock*:            lock_try_acquire)(lock)
+
+#define spin_release(lock)                                                                             \
+	_Generic((lock),                                                                                   \
+		struct TAS_Lock*:        SPIN_INLINE(TAS_release_inline,             TAS_release),             \
+		struct TTAS_Lock*:       SPIN_INLINE(TTAS_release_inline,            TTAS_release),            \
+		struct TicketLock*:      SPIN_INLINE(TicketLock_release_inline,      TicketLock_release),      \
+		struct SplitTicketLock*: SPIN_INLINE(SplitTicketLock_release_inline, SplitTicketLock_release), \
+		struct Lock*:            lock_release)(lock)
+
+#endif // SPIN_LOCKS_INLINE_HPP_INCLUDED
@@ -0,0 +1,342 @@
+#define _GNU_SOURCE
+
+#include "Topology.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+
+//------------------
+// Topology storage 
+//------------------
+
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+
+static unsigned num_numa_nodes = 1;
+static unsigned cpu_to_numa_node[TOPOLOGY_MAX_CPUS];
+
+// Online CPUs in ascending order:
+static unsigned num_online_cpus = 0;
+static int      online_cpus[TOPOLOGY_MAX_CPUS];
+
+static unsigned num_cores    = 1;
+static unsigned num_packages = 1;
+
+// Dense indices of the CPU's package, of its core among all cores and among
+// the cores of the package, and the CPU's rank among its SMT siblings:
+static unsigned cpu_to_package     [TOPOLOGY_MAX_CPUS];
+static unsigned cpu_to_core        [TOPOLOGY_MAX_CPUS];
+static unsigned cpu_to_package_core[TOPOLOGY_MAX_CPUS];
+static unsigned cpu_to_smt_rank    [TOPOLOGY_MAX_CPUS];
+
+//----------------
+// Sysfs parsing 
+//----------------
+
+// Parse a cpulist like "0-3,8-11" and call mark(cpu, value) for every cpu in it.
+// Returns the number of cpus listed or -1 if the file can't be read.
+static int parse_cpulist(const char* path, void (*mark)(int, unsigned), unsigned value)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL) return -1;
+
+	int num_cpus = 0;
+
+	int first, last;
+	while (fscanf(file, "%d", &first) == 1)
+	{
+		last = first;
+
+		int separator = fgetc(file);
+		if (separator == '-')
+		{
+			if (fscanf(file, "%d", &last) != 1) break;
+
+			separator = fgetc(file);
+		}
+
+		for (int cpu = first; cpu <= last && cpu < TOPOLOGY_MAX_CPUS; ++cpu)
+		{
+			mark(cpu, value);
+			num_cpus += 1;
+		}
+
+		if (separator != ',') break;
+	}
+
+	fclose(file);
+
+	return num_cpus;
+}
+
+static void mark_numa_node(int cpu, unsigned node)
+{
+	cpu_to_numa_node[cpu] = node;
+}
+
+static void mark_online(int cpu, unsigned unused)
+{
+	online_cpus[num_online_cpus++] = cpu;
+}
+
+// Read a single integer like /sys/devices/system/cpu/cpu0/topology/core_id:
+static int read_sysfs_int(const char* path, int* value)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL) return -1;
+
+	int num_read = fscanf(file, "%d", value);
+
+	fclose(file);
+
+	return (num_read == 1)? 0 : -1;
+}
+
+static void read_cpu_topology()
+{
+	if (parse_cpulist("/sys/devices/system/cpu/online", mark_online, 0) <= 0)
+	{
+		num_online_cpus = 0;
+
+		for (unsigned cpu = 0; cpu < topology_num_cpus() && cpu < TOPOLOGY_MAX_CPUS; ++cpu)
+		{
+			online_cpus[num_online_cpus++] = cpu;
+		}
+	}
+
+	// Package and core ids as reported by the kernel, they may have holes:
+	static int package_ids[TOPOLOGY_MAX_CPUS];
+	static int core_ids   [TOPOLOGY_MAX_CPUS];
+
+	num_cores    = 0;
+	num_packages = 0;
+
+	for (unsigned cpu_i = 0; cpu_i < num_online_cpus; ++cpu_i)
+	{
+		int cpu = online_cpus[cpu_i];
+
+		char path[96];
+		int package_id, core_id;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+		if (read_sysfs_int(path, &package_id) != 0) package_id = 0;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+		if (read_sysfs_int(path, &core_id) != 0) core_id = cpu;
+
+		package_ids[cpu_i] = package_id;
+		core_ids   [cpu_i] = core_id;
+
+		// Renumber densely in the order of appearance:
+		unsigned package = 0;
+		while (package < cpu_i && package_ids[package] != package_id) ++package;
+
+		cpu_to_package[cpu] = (package == cpu_i)? num_packages++ : cpu_to_package[online_cpus[package]];
+
+		unsigned sibling = 0;
+		while (sibling < cpu_i && (package_ids[sibling] != package_id || core_ids[sibling] != core_id)) ++sibling;
+
+		if (sibling == cpu_i)
+		{
+			// New core, count the cores of its package seen so far:
+			unsigned package_cores = 0;
+			for (unsigned other = 0; other < cpu_i; ++other)
+			{
+				int other_cpu = online_cpus[other];
+
+				if (cpu_to_package[other_cpu] == cpu_to_package[cpu] && cpu_to_smt_rank[other_cpu] == 0)
+					package_cores += 1;
+			}
+
+			cpu_to_core        [cpu] = num_cores++;
+			cpu_to_package_core[cpu] = package_cores;
+			cpu_to_smt_rank    [cpu] = 0;
+		}
+		else
+		{
+			int first_sibling = online_cpus[sibling];
+
+			unsigned rank = 0;
+			for (unsigned other = 0; other < cpu_i; ++other)
+			{
+				if (cpu_to_core[online_cpus[other]] == cpu_to_core[first_sibling]) rank += 1;
+			}
+
+			cpu_to_core        [cpu] = cpu_to_core        [first_sibling];
+			cpu_to_package_core[cpu] = cpu_to_package_core[first_sibling];
+			cpu_to_smt_rank    [cpu] = rank;
+		}
+	}
+
+	if (num_cores    == 0) num_cores    = 1;
+	if (num_packages == 0) num_packages = 1;
+}
+
+static void read_topology()
+{
+	for (unsigned cpu = 0; cpu < TOPOLOGY_MAX_CPUS; ++cpu)
+	{
+		cpu_to_numa_node[cpu] = 0;
+	}
+
+	// Node numbers may have holes, so renumber nodes with CPUs densely:
+	unsigned found_nodes = 0;
+
+	for (unsigned node = 0; node < TOPOLOGY_MAX_NUMA_NODES; ++node)
+	{
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+
+		int num_cpus = parse_cpulist(path, mark_numa_node, found_nodes);
+		if (num_cpus < 0) continue;
+
+		// Memory-only nodes are of no use for lock placement:
+		if (num_cpus > 0) found_nodes += 1;
+	}
+
+	num_numa_nodes = (found_nodes == 0)? 1 : found_nodes;
+
+	read_cpu_topology();
+}
+
+//--------------
+// Topology API 
+//--------------
+
+unsigned topology_num_cpus()
+{
+	long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (num_cpus < 1)? 1 : (unsigned) num_cpus;
+}
+
+unsigned topology_online_cpus(int* cpus)
+{
+	pthread_once(&topology_once, read_topology);
+
+	for (unsigned cpu_i = 0; cpu_i < num_online_cpus; ++cpu_i)
+	{
+		cpus[cpu_i] = online_cpus[cpu_i];
+	}
+
+	return num_online_cpus;
+}
+
+unsigned topology_num_cores()
+{
+	pthread_once(&topology_once, read_topology);
+
+	return num_cores;
+}
+
+unsigned topology_num_packages()
+{
+	pthread_once(&topology_once, read_topology);
+
+	return num_packages;
+}
+
+unsigned topology_num_numa_nodes()
+{
+	pthread_once(&topology_once, read_topology);
+
+	return num_numa_nodes;
+}
+
+unsigned topology_numa_node_of_cpu(int cpu)
+{
+	pthread_once(&topology_once, read_topology);
+
+	if (cpu < 0 || cpu >= TOPOLOGY_MAX_CPUS) return 0;
+
+	return cpu_to_numa_node[cpu];
+}
+
+unsigned topology_current_numa_node()
+{
+	return topology_numa_node_of_cpu(sched_getcpu());
+}
+
+//------------------
+// Thread placement 
+//------------------
+
+const char* topology_placement_name(enum TopologyPlacement placement)
+{
+	switch (placement)
+	{
+		case PLACEMENT_NONE:         return "unpinned";
+		case PLACEMENT_COMPACT:      return "compact";
+		case PLACEMENT_SCATTER:      return "scatter";
+		case PLACEMENT_CROSS_SOCKET: return "cross-socket";
+	}
+
+	return "unknown";
+}
+
+struct PlacementSlot
+{
+	unsigned long long key;
+	int cpu;
+};
+
+static int compare_placement_slots(const void* lhs, const void* rhs)
+{
+	unsigned long long lhs_key = ((const struct PlacementSlot*) lhs)->key;
+	unsigned long long rhs_key = ((const struct PlacementSlot*) rhs)->key;
+
+	return (lhs_key > rhs_key) - (lhs_key < rhs_key);
+}
+
+// Lexicographic order of three indices below TOPOLOGY_MAX_CPUS:
+static unsigned long long placement_key(unsigned major, unsigned middle, unsigned minor)
+{
+	return ((unsigned long long) major * TOPOLOGY_MAX_CPUS + middle) * TOPOLOGY_MAX_CPUS + minor;
+}
+
+unsigned topology_placement_order(enum TopologyPlacement placement, int* cpus)
+{
+	pthread_once(&topology_once, read_topology);
+
+	static struct PlacementSlot slots[TOPOLOGY_MAX_CPUS];
+
+	// Pinning to a CPU outside the affinity mask (taskset, cpusets) fails:
+	cpu_set_t allowed;
+	int check_allowed = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+
+	unsigned num_slots = 0;
+
+	for (unsigned online_i = 0; online_i < num_online_cpus; ++online_i)
+	{
+		int cpu = online_cpus[online_i];
+
+		if (check_allowed && !CPU_ISSET(cpu, &allowed)) continue;
+
+		unsigned cpu_i = num_slots++;
+
+		unsigned package      = cpu_to_package     [cpu];
+		unsigned package_core = cpu_to_package_core[cpu];
+		unsigned smt_rank     = cpu_to_smt_rank    [cpu];
+
+		switch (placement)
+		{
+			case PLACEMENT_COMPACT:      slots[cpu_i].key = placement_key(package,  package_core, smt_rank); break;
+			case PLACEMENT_SCATTER:      slots[cpu_i].key = placement_key(smt_rank, package,      package_core); break;
+			case PLACEMENT_CROSS_SOCKET: slots[cpu_i].key = placement_key(smt_rank, package_core, package); break;
+			default:                     slots[cpu_i].key = cpu_i;
+		}
+
+		slots[cpu_i].cpu = cpu;
+	}
+
+	qsort(slots, num_slots, sizeof(struct PlacementSlot), compare_placement_slots);
+
+	for (unsigned cpu_i = 0; cpu_i < num_slots; ++cpu_i)
+	{
+		cpus[cpu_i] = slots[cpu_i].cpu;
+	}
+
+	return num_slots;
+}
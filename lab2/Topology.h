@@ -0,0 +1,67 @@
+#ifndef TOPOLOGY_HPP_INCLUDED
+#define TOPOLOGY_HPP_INCLUDED
+
+//------------------------------------------------------------------
+// Machine topology
+//------------------------------------------------------------------
+// The topology is read from sysfs once on the first call:
+// - NUMA nodes from /sys/devices/system/node/node*/cpulist
+// - Online CPUs from /sys/devices/system/cpu/online
+// - Cores and packages from /sys/devices/system/cpu/cpu*/topology
+// If sysfs is unavailable, the machine is treated as a single node
+// and a single package of single-threaded cores.
+//------------------------------------------------------------------
+
+#define TOPOLOGY_MAX_CPUS       1024
+#define TOPOLOGY_MAX_NUMA_NODES   64
+
+// Number of online CPUs:
+unsigned topology_num_cpus();
+
+// Fill cpus[] (TOPOLOGY_MAX_CPUS entries) with the online CPU ids in ascending order,
+// returns the number of CPUs:
+unsigned topology_online_cpus(int* cpus);
+
+// Number of physical cores and packages (sockets) with online CPUs:
+unsigned topology_num_cores();
+unsigned topology_num_packages();
+
+// Number of NUMA nodes that have CPUs:
+unsigned topology_num_numa_nodes();
+
+// NUMA node index (0 .. topology_num_numa_nodes()-1) of the given CPU:
+unsigned topology_numa_node_of_cpu(int cpu);
+
+// NUMA node index of the CPU the calling thread is running on:
+unsigned topology_current_numa_node();
+
+//------------------------------------------------------------------
+// Thread placement
+//------------------------------------------------------------------
+// Order in which threads are pinned to the online CPUs:
+// - Compact: fill all SMT siblings of a core, then the next core
+//   of the same package, then the next package
+// - Scatter: one thread per physical core first, SMT siblings
+//   only after every core is taken
+// - Cross-socket: like scatter, but consecutive threads alternate
+//   between packages
+//------------------------------------------------------------------
+
+enum TopologyPlacement
+{
+	PLACEMENT_NONE,
+	PLACEMENT_COMPACT,
+	PLACEMENT_SCATTER,
+	PLACEMENT_CROSS_SOCKET
+};
+
+#define TOPOLOGY_NUM_PLACEMENTS 4
+
+const char* topology_placement_name(enum TopologyPlacement placement);
+
+// Fill cpus[] (TOPOLOGY_MAX_CPUS entries) with the online CPUs of the process's
+// affinity mask in placement order, returns the number of CPUs (0 leaves threads
+// unpinned). Thread i goes to cpus[i % number of CPUs].
+unsigned topology_placement_order(enum TopologyPlacement placement, int* cpus);
+
+#endif // TOPOLOGY_HPP_INCLUDED
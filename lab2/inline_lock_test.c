@@ -0,0 +1,82 @@
+// Multithreaded Programming
+// Lab#02: Spin-lock Benchmarking
+//===================================================================
+// Uncontended lock latency
+// One thread acquires and releases a lock N times in a row through
+// the operation table (struct Lock), through direct out-of-line
+// calls and through the inline front-end of SpinLocksInline.h.
+// Average TSC cycles per acquire/release pair are the output.
+//-------------------------------------------------------------------
+// Always built with -O2 (see the Makefile): at -O0 nothing is
+// inlined and every column measures call overhead.
+//-------------------------------------------------------------------
+
+#include "SpinLocksInline.h"
+#include "SpinLockBenchmarks.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <x86intrin.h>
+
+const long INLINE_TEST_NUM_ACQUISITIONS = 10000000;
+
+// Columns: operation table, out-of-line calls, inline front-end:
+#define UNCONTENDED_TEST(prefix, type, ops)                                                          \
+	void prefix##_uncontended_test()                                                                 \
+	{                                                                                                \
+		struct Lock table_lock;                                                                      \
+		if (lock_create(&table_lock, &ops) != 0)                                                     \
+		{                                                                                            \
+			fprintf(stderr, MAGENTA "[Error] Unable to init %s\n" RESET, ops.name);                  \
+			exit(EXIT_FAILURE);                                                                      \
+		}                                                                                            \
+                                                                                                     \
+		struct type* lock = (struct type*) table_lock.instance;                                      \
+                                                                                                     \
+		uint64_t start = __rdtsc();                                                                  \
+		for (long acquisition = 0; acquisition < INLINE_TEST_NUM_ACQUISITIONS; ++acquisition)        \
+		{                                                                                            \
+			spin_acquire(&table_lock);                                                               \
+			spin_release(&table_lock);                                                               \
+		}                                                                                            \
+		double table_cycles = (double) (__rdtsc() - start) / INLINE_TEST_NUM_ACQUISITIONS;           \
+                                                                                                     \
+		start = __rdtsc();                                                                           \
+		for (long acquisition = 0; acquisition < INLINE_TEST_NUM_ACQUISITIONS; ++acquisition)        \
+		{                                                                                            \
+			prefix##_acquire(lock);                                                                  \
+			prefix##_release(lock);                                                                  \
+		}                                                                                            \
+		double call_cycles = (double) (__rdtsc() - start) / INLINE_TEST_NUM_ACQUISITIONS;            \
+                                                                                                     \
+		start = __rdtsc();                                                                           \
+		for (long acquisition = 0; acquisition < INLINE_TEST_NUM_ACQUISITIONS; ++acquisition)        \
+		{                                                                                            \
+			spin_acquire(lock);                                                                      \
+			spin_release(lock);                                                                      \
+		}                                                                                            \
+		double inline_cycles = (double) (__rdtsc() - start) / INLINE_TEST_NUM_ACQUISITIONS;          \
+                                                                                                     \
+		printf(YELLOW "%-30s %10.1f %10.1f %10.1f\n" RESET, ops.name, table_cycles, call_cycles, inline_cycles); \
+                                                                                                     \
+		lock_destroy(&table_lock);                                                                   \
+	}
+
+UNCONTENDED_TEST(TAS,             TAS_Lock,        TAS_LOCK_OPS)
+UNCONTENDED_TEST(TTAS,            TTAS_Lock,       TTAS_LOCK_OPS)
+UNCONTENDED_TEST(TicketLock,      TicketLock,      TICKET_LOCK_OPS)
+UNCONTENDED_TEST(SplitTicketLock, SplitTicketLock, SPLIT_TICKET_LOCK_OPS)
+
+int main()
+{
+	printf(CYAN "Uncontended acquire/release (TSC cycles per pair):\n" RESET);
+	printf(CYAN "%-30s %10s %10s %10s\n" RESET, "", "struct Lock", "call", "inline");
+
+	TAS_uncontended_test();
+	TTAS_uncontended_test();
+	TicketLock_uncontended_test();
+	SplitTicketLock_uncontended_test();
+
+	return EXIT_SUCCESS;
+}
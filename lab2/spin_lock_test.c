@@ -1,127 +1,429 @@
 #include "SpinLockBenchmarks.h"
+#include "LockInterface.h"
 #include "SpinLocks.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-// TAS lock 
+//-------
+// Locks 
+//-------
 
-struct TAS_Lock TAS_test;
+#define NUM_LOCKS 17
 
-void TAS_test_init()
+// Baselines go first, every lock is compared to them:
+const struct LockOps* LOCKS[NUM_LOCKS] = 
 {
-	
-	TAS_init(&TAS_test);
-}
+	&PTHREAD_MUTEX_OPS,
+	&PTHREAD_SPINLOCK_OPS,
+	&ATOMIC_FLAG_LOCK_OPS,
+	&TICKET_LOCK_OPS,
+	&CLH_LOCK_OPS,
+	&ANDERSON_LOCK_OPS,
+	&TIME_PUBLISHED_LOCK_OPS,
+	&COHORT_LOCK_OPS,
+	&HYBRID_LOCK_OPS,
+	&BIASED_LOCK_OPS,
+	&ADAPTIVE_LOCK_OPS,
+	&TAS_LOCK_OPS,
+	&TTAS_LOCK_OPS,
+	&TAS_PADDED_LOCK_OPS,
+	&TTAS_PADDED_LOCK_OPS,
+	&TICKET_PADDED_LOCK_OPS,
+	&SPLIT_TICKET_LOCK_OPS
+};
 
-void TAS_test_acquire()
-{
-	
-	TAS_acquire(&TAS_test);
-}
+// Queue locks under oversubscription, the ticket lock is the baseline:
+#define NUM_TAIL_LATENCY_LOCKS 3
 
-void TAS_test_release()
+const struct LockOps* TAIL_LATENCY_LOCKS[NUM_TAIL_LATENCY_LOCKS] = 
 {
-	
-	TAS_release(&TAS_test);
-}
+	&TICKET_LOCK_OPS,
+	&CLH_LOCK_OPS,
+	&TIME_PUBLISHED_LOCK_OPS
+};
 
+// Owner-affine locks under skewed ownership, TTAS is the baseline:
+#define NUM_SKEWED_LOCKS 2
 
-// TTAS lock 
+const struct LockOps* SKEWED_LOCKS[NUM_SKEWED_LOCKS] = 
+{
+	&TTAS_LOCK_OPS,
+	&BIASED_LOCK_OPS
+};
 
-struct TTAS_Lock TTAS_test;
+// Share of the acquisitions done by the dominant thread:
+#define NUM_OWNER_PERCENTS 4
 
-void TTAS_test_init()
-{
-	TTAS_init(&TTAS_test);
-}
+const unsigned OWNER_PERCENTS[NUM_OWNER_PERCENTS] = {100, 99, 90, 50};
 
-void TTAS_test_acquire()
-{
-	TTAS_acquire(&TTAS_test);
-}
+// Fixed spin and backoff constants against the self-tuning lock:
+#define NUM_CS_SWEEP_LOCKS 5
 
-void TTAS_test_release()
+const struct LockOps* CS_SWEEP_LOCKS[NUM_CS_SWEEP_LOCKS] = 
 {
-	TTAS_release(&TTAS_test);
-}
+	&TAS_LOCK_OPS,
+	&TTAS_LOCK_OPS,
+	&TICKET_LOCK_OPS,
+	&HYBRID_LOCK_OPS,
+	&ADAPTIVE_LOCK_OPS
+};
 
-//--------------
-// Ticket lock 
-//--------------
+// Critical section lengths (increments) for the sweep:
+#define NUM_CS_LENGTHS 5
 
-struct TicketLock ticket_test;
+const unsigned CS_LENGTHS[NUM_CS_LENGTHS] = {1, 10, 100, 1000, 10000};
 
-void ticket_test_init()
+// Packed next to padded layouts, every lock is compared to its padded twin:
+#define NUM_ADJACENT_LOCKS 27
+
+const struct LockOps* ADJACENT_LOCKS[NUM_ADJACENT_LOCKS] = 
 {
-	TicketLock_init(&ticket_test);
-}
+	&TAS_LOCK_OPS,
+	&TAS_PADDED_LOCK_OPS,
+	&TTAS_LOCK_OPS,
+	&TTAS_PADDED_LOCK_OPS,
+	&TICKET_LOCK_OPS,
+	&TICKET_PADDED_LOCK_OPS,
+	&SPLIT_TICKET_LOCK_OPS,
+	&CLH_LOCK_OPS,
+	&CLH_PADDED_LOCK_OPS,
+	&ANDERSON_LOCK_OPS,
+	&ANDERSON_PADDED_LOCK_OPS,
+	&TIME_PUBLISHED_LOCK_OPS,
+	&TIME_PUBLISHED_PADDED_LOCK_OPS,
+	&COHORT_LOCK_OPS,
+	&COHORT_PADDED_LOCK_OPS,
+	&HYBRID_LOCK_OPS,
+	&HYBRID_PADDED_LOCK_OPS,
+	&ADAPTIVE_LOCK_OPS,
+	&ADAPTIVE_PADDED_LOCK_OPS,
+	&RW_LOCK_OPS,
+	&RW_PADDED_LOCK_OPS,
+	&PHASE_FAIR_RW_LOCK_OPS,
+	&PHASE_FAIR_RW_PADDED_LOCK_OPS,
+	&DISTRIBUTED_RW_LOCK_OPS,
+	&DISTRIBUTED_RW_PADDED_LOCK_OPS,
+	&FLAT_COMBINING_LOCK_OPS,
+	&FLAT_COMBINING_PADDED_LOCK_OPS
+};
+
+#define NUM_RW_LOCKS 3
 
-void ticket_test_acquire()
+const struct LockOps* RW_LOCKS[NUM_RW_LOCKS] = 
 {
-	TicketLock_acquire(&ticket_test);
-}
+	&RW_LOCK_OPS,
+	&PHASE_FAIR_RW_LOCK_OPS,
+	&DISTRIBUTED_RW_LOCK_OPS
+};
+
+// Delegation locks run their critical sections through lock_execute(),
+// they are compared to a few usual locks doing the same:
+#define NUM_DELEGATION_LOCKS 5
 
-void ticket_test_release()
+const struct LockOps* DELEGATION_LOCKS[NUM_DELEGATION_LOCKS] = 
 {
-	TicketLock_release(&ticket_test);
-}
+	&TICKET_LOCK_OPS,
+	&TTAS_LOCK_OPS,
+	&CLH_LOCK_OPS,
+	&FLAT_COMBINING_LOCK_OPS,
+	&DELEGATION_LOCK_OPS
+};
 
+//----------
+// Barriers 
+//----------
 
-// Main 
+#define NUM_BARRIERS 4
 
+// The baseline goes first:
+const struct BarrierOps* BARRIERS[NUM_BARRIERS] = 
+{
+	&PTHREAD_BARRIER_OPS,
+	&SENSE_BARRIER_OPS,
+	&TREE_BARRIER_OPS,
+	&DISSEMINATION_BARRIER_OPS
+};
 
-#define NUM_LOCKS 3
+//----------------
+// Backoff jitter 
+//----------------
 
-const char* LOCK_NAMES[NUM_LOCKS] = 
+// TAS and TTAS run with every source, the default goes last:
+#define NUM_JITTER_LOCKS 2
+
+const struct LockOps* JITTER_LOCKS[NUM_JITTER_LOCKS] = 
 {
-	"Ticket lock",
-	"TAS lock",
-	"TTAS lock"
+	&TAS_LOCK_OPS,
+	&TTAS_LOCK_OPS
 };
 
-void (*LOCK_INITS[NUM_LOCKS])() = 
+#define NUM_JITTER_SOURCES 2
+
+const BackoffJitter JITTER_SOURCES[NUM_JITTER_SOURCES] = 
 {
-	ticket_test_init,
-	TAS_test_init,
-	TTAS_test_init
+	libc_rand_jitter,
+	fast_random_jitter
 };
 
-void (*LOCK_ACQUIRES[NUM_LOCKS])() = 
+const char* JITTER_SOURCE_NAMES[NUM_JITTER_SOURCES] = 
 {
-	ticket_test_acquire,
-	TAS_test_acquire,
-	TTAS_test_acquire
+	"rand()",
+	"fast_random()"
 };
 
-void (*LOCK_RELEASES[NUM_LOCKS])() = 
+// Percentage of shared acquisitions for read-scalability curves:
+#define NUM_READ_PERCENTS 4
+
+const unsigned READ_PERCENTS[NUM_READ_PERCENTS] = {0, 50, 90, 99};
+
+const unsigned RW_CORRECTNESS_READ_PERCENT = 90;
+
+// Timeouts for the timed acquisition test:
+#define NUM_TIMEOUTS 2
+
+const unsigned long long TIMEOUTS_NS[NUM_TIMEOUTS] = {10000, 1000000};
+
+// Critical sections and think times for the workload test:
+#define NUM_WORKLOADS 4
+
+const struct Workload WORKLOADS[NUM_WORKLOADS] =
 {
-	ticket_test_release,
-	TAS_test_release,
-	TTAS_test_release
+	{.num_cache_lines = 4, .mean_think_ns =      0},
+	{.num_cache_lines = 4, .mean_think_ns =   1000},
+	{.num_cache_lines = 4, .mean_think_ns =  10000},
+	{.num_cache_lines = 4, .mean_think_ns = 100000}
 };
 
+void create_lock(struct Lock* lock, const struct LockOps* ops)
+{
+	if (lock_create(lock, ops) != 0)
+	{
+		fprintf(stderr, MAGENTA "[Error] Unable to init %s\n" RESET, ops->name);
+		exit(EXIT_FAILURE);
+	}
+}
+
 int main()
 {
 	for (unsigned lock_i = 0; lock_i < NUM_LOCKS; ++lock_i)
 	{
 		// Init lock:
-		LOCK_INITS[lock_i]();
+		struct Lock lock;
+		create_lock(&lock, LOCKS[lock_i]);
+
+		const char* lock_name = LOCKS[lock_i]->name;
 
 		// Correctness:
-		printf(CYAN "%s correctness test:\n" RESET, LOCK_NAMES[lock_i]);
+		printf(CYAN "%s correctness test:\n" RESET, lock_name);
 
-		run_correctness_test(LOCK_ACQUIRES[lock_i], LOCK_RELEASES[lock_i]);
+		run_correctness_test(&lock);
 
 		// Performance:
-		printf(CYAN "%s performance test:\n" RESET, LOCK_NAMES[lock_i]);
+		for (unsigned placement = 0; placement < TOPOLOGY_NUM_PLACEMENTS; ++placement)
+		{
+			printf(CYAN "%s performance test (%s):\n" RESET, lock_name, topology_placement_name(placement));
 
-		run_performance_test(LOCK_ACQUIRES[lock_i], LOCK_RELEASES[lock_i]);
+			run_performance_test(&lock, placement);
+		}
 		
 		// Fairness:
-		printf(CYAN "%s fairness test:\n" RESET, LOCK_NAMES[lock_i]);
+		printf(CYAN "%s fairness test:\n" RESET, lock_name);
+
+		run_fairness_test(&lock);
+
+		// Oversubscription:
+		printf(CYAN "%s oversubscription test:\n" RESET, lock_name);
+
+		run_oversubscription_test(&lock);
+
+		// Timed acquisition:
+		for (unsigned timeout_i = 0; timeout_i < NUM_TIMEOUTS; ++timeout_i)
+		{
+			printf(CYAN "%s timed acquisition test (%llu ns timeout):\n" RESET, lock_name, TIMEOUTS_NS[timeout_i]);
+
+			run_timed_test(&lock, TIMEOUTS_NS[timeout_i]);
+		}
+
+		// Throughput:
+		for (unsigned placement = 0; placement < TOPOLOGY_NUM_PLACEMENTS; ++placement)
+		{
+			printf(CYAN "%s throughput test (%s, acquisitions per second):\n" RESET, lock_name, topology_placement_name(placement));
+
+			run_throughput_test(&lock, placement);
+		}
+
+		// Workloads from saturated to uncontended:
+		for (unsigned workload_i = 0; workload_i < NUM_WORKLOADS; ++workload_i)
+		{
+			printf(CYAN "%s workload test (%u cache lines, %u ns think time, acquisitions per second):\n" RESET,
+			       lock_name, WORKLOADS[workload_i].num_cache_lines, WORKLOADS[workload_i].mean_think_ns);
+
+			run_workload_test(&lock, WORKLOADS[workload_i]);
+		}
+
+		lock_destroy(&lock);
+	}
+
+	for (unsigned lock_i = 0; lock_i < NUM_RW_LOCKS; ++lock_i)
+	{
+		// Init lock:
+		struct Lock lock;
+		create_lock(&lock, RW_LOCKS[lock_i]);
+
+		const char* lock_name = RW_LOCKS[lock_i]->name;
+
+		// Correctness:
+		printf(CYAN "%s correctness test (%u%% reads):\n" RESET, lock_name, RW_CORRECTNESS_READ_PERCENT);
+
+		run_rw_correctness_test(&lock, RW_CORRECTNESS_READ_PERCENT);
+
+		// Read scalability:
+		for (unsigned percent_i = 0; percent_i < NUM_READ_PERCENTS; ++percent_i)
+		{
+			printf(CYAN "%s performance test (%u%% reads):\n" RESET, lock_name, READ_PERCENTS[percent_i]);
+
+			run_rw_performance_test(&lock, READ_PERCENTS[percent_i]);
+		}
+
+		lock_destroy(&lock);
+	}
+
+	// Tail latency with preempted waiters:
+	for (unsigned lock_i = 0; lock_i < NUM_TAIL_LATENCY_LOCKS; ++lock_i)
+	{
+		struct Lock lock;
+		create_lock(&lock, TAIL_LATENCY_LOCKS[lock_i]);
+
+		printf(CYAN "%s oversubscribed tail latency test:\n" RESET, TAIL_LATENCY_LOCKS[lock_i]->name);
+
+		run_oversubscribed_latency_test(&lock);
+
+		lock_destroy(&lock);
+	}
+
+	// Skewed ownership:
+	for (unsigned lock_i = 0; lock_i < NUM_SKEWED_LOCKS; ++lock_i)
+	{
+		for (unsigned percent_i = 0; percent_i < NUM_OWNER_PERCENTS; ++percent_i)
+		{
+			printf(CYAN "%s skewed ownership test (%u%% by one thread, ns per acquisition):\n" RESET,
+			       SKEWED_LOCKS[lock_i]->name, OWNER_PERCENTS[percent_i]);
 
-		run_fairness_test(LOCK_ACQUIRES[lock_i], LOCK_RELEASES[lock_i]);
+			run_skewed_test(SKEWED_LOCKS[lock_i], OWNER_PERCENTS[percent_i]);
+		}
 	}
 
+	// Critical section length sweep:
+	for (unsigned lock_i = 0; lock_i < NUM_CS_SWEEP_LOCKS; ++lock_i)
+	{
+		struct Lock lock;
+		create_lock(&lock, CS_SWEEP_LOCKS[lock_i]);
+
+		printf(CYAN "%s critical section length sweep test:\n" RESET, CS_SWEEP_LOCKS[lock_i]->name);
+
+		for (unsigned length_i = 0; length_i < NUM_CS_LENGTHS; ++length_i)
+		{
+			run_cs_sweep_test(&lock, CS_LENGTHS[length_i]);
+		}
+
+		lock_destroy(&lock);
+	}
+
+	// False sharing between neighbouring locks:
+	for (unsigned lock_i = 0; lock_i < NUM_ADJACENT_LOCKS; ++lock_i)
+	{
+		printf(CYAN "%s adjacent locks test (%s):\n" RESET, ADJACENT_LOCKS[lock_i]->name,
+		       (ADJACENT_LOCKS[lock_i]->size < L1D_LINESIZE)? "packed" : "a line each");
+
+		run_adjacent_locks_test(ADJACENT_LOCKS[lock_i]);
+	}
+
+	// Delegation:
+	for (unsigned lock_i = 0; lock_i < NUM_DELEGATION_LOCKS; ++lock_i)
+	{
+		struct Lock lock;
+		create_lock(&lock, DELEGATION_LOCKS[lock_i]);
+
+		const char* lock_name = DELEGATION_LOCKS[lock_i]->name;
+
+		// The usual locks went through these above:
+		if (DELEGATION_LOCKS[lock_i]->execute != NULL)
+		{
+			printf(CYAN "%s correctness test:\n" RESET, lock_name);
+
+			run_correctness_test(&lock);
+
+			for (unsigned placement = 0; placement < TOPOLOGY_NUM_PLACEMENTS; ++placement)
+			{
+				printf(CYAN "%s performance test (%s):\n" RESET, lock_name, topology_placement_name(placement));
+
+				run_performance_test(&lock, placement);
+			}
+		}
+
+		printf(CYAN "%s delegation throughput test (critical sections per second):\n" RESET, lock_name);
+
+		run_delegation_test(&lock);
+
+		lock_destroy(&lock);
+	}
+
+	// Sequence lock:
+	for (unsigned percent_i = 0; percent_i < NUM_READ_PERCENTS; ++percent_i)
+	{
+		printf(CYAN "SeqLock read test (%u%% reads, ns per access):\n" RESET, READ_PERCENTS[percent_i]);
+
+		run_seqlock_test(READ_PERCENTS[percent_i]);
+	}
+
+	// Barriers, spinning waiters yield or sleep on a futex:
+	for (unsigned barrier_i = 0; barrier_i < NUM_BARRIERS; ++barrier_i)
+	{
+		for (int futex_fallback = 0; futex_fallback <= 1; ++futex_fallback)
+		{
+			// pthread_barrier always sleeps:
+			if (futex_fallback && BARRIERS[barrier_i] == &PTHREAD_BARRIER_OPS) continue;
+
+			printf(CYAN "%s crossing test (%s, ns per crossing):\n" RESET,
+			       BARRIERS[barrier_i]->name, futex_fallback? "futex fallback" : "yield");
+
+			run_barrier_test(BARRIERS[barrier_i], futex_fallback);
+		}
+	}
+
+	// Backoff jitter sources:
+	for (unsigned lock_i = 0; lock_i < NUM_JITTER_LOCKS; ++lock_i)
+	{
+		struct Lock lock;
+		create_lock(&lock, JITTER_LOCKS[lock_i]);
+
+		const char* lock_name = JITTER_LOCKS[lock_i]->name;
+
+		for (unsigned source_i = 0; source_i < NUM_JITTER_SOURCES; ++source_i)
+		{
+			spin_backoff_jitter = JITTER_SOURCES[source_i];
+
+			for (unsigned placement = 0; placement < TOPOLOGY_NUM_PLACEMENTS; ++placement)
+			{
+				printf(CYAN "%s performance test (%s backoff jitter, %s):\n" RESET,
+				       lock_name, JITTER_SOURCE_NAMES[source_i], topology_placement_name(placement));
+
+				run_performance_test(&lock, placement);
+			}
+
+			for (unsigned placement = 0; placement < TOPOLOGY_NUM_PLACEMENTS; ++placement)
+			{
+				printf(CYAN "%s throughput test (%s backoff jitter, %s, acquisitions per second):\n" RESET,
+				       lock_name, JITTER_SOURCE_NAMES[source_i], topology_placement_name(placement));
+
+				run_throughput_test(&lock, placement);
+			}
+		}
+
+		lock_destroy(&lock);
+	}
+
+	spin_backoff_jitter = fast_random_jitter;
+
 	return EXIT_SUCCESS;
 }
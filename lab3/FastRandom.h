@@ -0,0 +1,53 @@
+#ifndef FAST_RANDOM_HPP_INCLUDED
+#define FAST_RANDOM_HPP_INCLUDED
+
+//------------------------------------------------------------------
+// Thread-local pseudo-random number generator
+//------------------------------------------------------------------
+// Xorshift64* with the state in thread-local storage:
+// - No locks and no shared writes, unlike rand() and random(),
+//   which serialize every caller on an internal lock
+// - Lazily seeded from the address of the thread's own state
+// - Not suitable for cryptography, only for jitter and sampling
+//------------------------------------------------------------------
+
+#include <stdint.h>
+
+static _Thread_local uint64_t fast_random_state = 0;
+
+static inline uint64_t fast_random_seed()
+{
+	// SplitMix64 of a per-thread address, so threads get distinct streams.
+	// The constant is XOR-ed rather than added: GCC folds an added constant
+	// into the TLS relocation at -O2, which then overflows at link time.
+	uint64_t seed = (uint64_t) (uintptr_t) &fast_random_state ^ 0x9E3779B97F4A7C15ull;
+
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+	seed =  seed ^ (seed >> 31);
+
+	return (seed == 0)? 1 : seed;
+}
+
+// Uniformly distributed 64-bit value:
+static inline uint64_t fast_random()
+{
+	uint64_t state = fast_random_state;
+	if (state == 0) state = fast_random_seed();
+
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+
+	fast_random_state = state;
+
+	return state * 0x2545F4914F6CDD1Dull;
+}
+
+// Uniformly distributed value in [0, bound) without a division:
+static inline uint32_t fast_random_below(uint32_t bound)
+{
+	return (uint32_t) (((fast_random() >> 32) * bound) >> 32);
+}
+
+#endif // FAST_RANDOM_HPP_INCLUDED
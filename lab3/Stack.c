@@ -7,8 +7,10 @@
 #include <memory.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <stdint.h>
 
 #include "Stack.h"
+#include "FastRandom.h"
 
 //--------
 // Colors 
@@ -27,23 +29,76 @@
 // Stack structures 
 //------------------
 
+#define CACHE_LINE_SIZE 64
+
 // Stack list node:
 struct StackNode
 {
 	volatile struct StackNode* next;
 
-	Data_t data;
+	union
+	{
+		Data_t data;
+
+		// Depot link (pool_index + 1 of the next magazine) and the number of nodes
+		// of the magazine, in its first node while it is in the node pool depot:
+		struct
+		{
+			unsigned next_magazine;
+			unsigned magazine_size;
+		};
+	};
+
+	// Position of the node in the pool, never changes (POOL_NO_INDEX for a node allocated past the pool):
+	unsigned pool_index;
+};
+
+// Singly linked list of free nodes:
+struct NodeMagazine
+{
+	struct StackNode* nodes;
+	unsigned num_nodes;
 };
 
-// Hazard pointer:
+// Hazard pointer (and the other per-thread state of the stack):
 struct HazardPointer
 {
 	volatile pid_t id;
 	volatile struct StackNode* pointer;
-};
+
+	// Free nodes, accessed by the owner thread only:
+	struct NodeMagazine magazine;
+
+	// The thread-exit destructor returns the magazine to this stack:
+	struct Stack* stack;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
 
 const unsigned MAX_HAZARD_POINTERS = 64;
 
+// Nodes are allocated in chunks and recycled through the pool, never freed before the stack.
+// Past POOL_MAX_CHUNKS chunks nodes are allocated one by one and freed once reclaimed:
+#define POOL_CHUNK_SIZE 1024
+#define POOL_MAX_CHUNKS 16384
+
+#define POOL_NO_INDEX 0xFFFFFFFFu
+
+// Magazines in the depot hold this many nodes, a thread keeps up to twice as many:
+const unsigned POOL_MAGAZINE_SIZE = 64;
+
+// Elimination array slot, holds a node offered by a push:
+struct EliminationSlot
+{
+	struct StackNode* volatile offer;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+#define ELIMINATION_ARRAY_SIZE 8
+
+// Set by the pop that takes the offer, the push clears it:
+#define ELIMINATION_TAKEN ((struct StackNode*) 1)
+
+// Pause-loop iterations a push waits for a pop to take its offer:
+const unsigned ELIMINATION_SPINS = 128;
+
 struct Stack
 {
 	// Hazard pointer thread-local storage:
@@ -52,6 +107,12 @@ struct Stack
 	// Hazard pointer array:
 	volatile struct HazardPointer* hazard_pointers;
 
+	// Node pool: chunks of nodes and the lock-free depot of free node magazines,
+	// the depot head is ((ABA tag << 32) | (pool_index + 1 of the top magazine)):
+	struct StackNode* volatile* pool_chunks;
+	volatile unsigned pool_num_chunks;
+	volatile uint64_t pool_depot;
+
 	// Reclamation list && user data destructor:
 	volatile struct StackNode* to_reclaim;
 	void (*data_destructor)(Data_t*);
@@ -60,6 +121,9 @@ struct Stack
 	// Stack operation:
 	volatile struct StackNode* head;
 
+	// Pushes and pops that collide on the head meet here:
+	struct EliminationSlot elimination[ELIMINATION_ARRAY_SIZE];
+
 	// Stack error-checking:
 	volatile int errno;
 };
@@ -85,10 +149,13 @@ int hazard_pointer_init(struct Stack* stack, struct HazardPointer** hp_ptr)
 		pid_t old_id = 0;
 
 		// Acquire a hazard pointer with a strong CAS, if it isn't taken already:
-		if (__atomic_compare_exchange_n(&stack->hazard_pointers[hp_i].id, &old_id, &thread_id, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		// Acquire pairs with the release in hazard_pointer_cleanup(), the previous owner emptied the magazine:
+		if (__atomic_compare_exchange_n(&stack->hazard_pointers[hp_i].id, &old_id, &thread_id, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
 		{
 			*hp_ptr = (struct HazardPointer*) &stack->hazard_pointers[hp_i];
 
+			(*hp_ptr)->stack = stack;
+
 			break;
 		}
 	}
@@ -102,24 +169,31 @@ int hazard_pointer_init(struct Stack* stack, struct HazardPointer** hp_ptr)
 	return 0;
 }
 
+void pool_flush(struct Stack* stack, struct NodeMagazine* magazine);
+
 void hazard_pointer_cleanup(void* arg)
 {
 	volatile struct HazardPointer* hp_ptr = (struct HazardPointer*) arg;
 
+	// Return free nodes to the stack's pool:
+	pool_flush(hp_ptr->stack, (struct NodeMagazine*) &hp_ptr->magazine);
+
 	// Clear the hazard pointer:
 	__atomic_store_n(&hp_ptr->pointer, NULL, __ATOMIC_RELAXED);
-	__atomic_store_n(&hp_ptr->id,         0, __ATOMIC_RELAXED);
+	__atomic_store_n(&hp_ptr->id,         0, __ATOMIC_RELEASE);
 }
 
 struct HazardPointer* get_hazard_pointer_for_current_thread(struct Stack* stack)
 {
 	struct HazardPointer* hp = (struct HazardPointer*) pthread_getspecific(stack->thread_local_key);
 
-	if (hp == NULL)
+	if (hp != NULL)
 	{
-		hazard_pointer_init(stack, &hp);
+		return hp;
 	}
 
+	hazard_pointer_init(stack, &hp);
+
 	if (pthread_setspecific(stack->thread_local_key, hp))
 	{
 		stack->errno = THREAD_LOCAL_ERROR;
@@ -142,6 +216,274 @@ bool outstanding_hazard_pointers_for(struct Stack* stack, struct StackNode* dang
 	return 0;
 }
 
+//-----------
+// Node pool 
+//-----------
+
+struct StackNode* pool_node(struct Stack* stack, unsigned pool_index)
+{
+	struct StackNode* chunk = __atomic_load_n(&stack->pool_chunks[pool_index / POOL_CHUNK_SIZE], __ATOMIC_RELAXED);
+
+	return chunk + pool_index % POOL_CHUNK_SIZE;
+}
+
+// Push a list of num_nodes free nodes to the depot as one magazine:
+void pool_depot_push(struct Stack* stack, struct StackNode* first, unsigned num_nodes)
+{
+	first->magazine_size = num_nodes;
+
+	uint64_t old_depot = __atomic_load_n(&stack->pool_depot, __ATOMIC_RELAXED);
+	uint64_t new_depot;
+
+	do
+	{
+		__atomic_store_n(&first->next_magazine, (unsigned) old_depot, __ATOMIC_RELAXED);
+
+		// Bump the tag, so a stale CAS in pool_depot_pop() fails:
+		new_depot = (((old_depot >> 32) + 1) << 32) | (first->pool_index + 1);
+	}
+	while (!__atomic_compare_exchange_n(&stack->pool_depot, &old_depot, new_depot, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Pop a magazine from the depot, NULL if it is empty:
+struct StackNode* pool_depot_pop(struct Stack* stack)
+{
+	uint64_t old_depot = __atomic_load_n(&stack->pool_depot, __ATOMIC_ACQUIRE);
+	uint64_t new_depot;
+
+	struct StackNode* first;
+
+	do
+	{
+		if ((unsigned) old_depot == 0)
+		{
+			return NULL;
+		}
+
+		first = pool_node(stack, (unsigned) old_depot - 1);
+
+		// The magazine may be taken and its nodes reused meanwhile, then the value is garbage,
+		// but the tag has changed and the CAS fails (nodes are never freed, so the read is safe):
+		unsigned next_magazine = __atomic_load_n(&first->next_magazine, __ATOMIC_RELAXED);
+
+		new_depot = (((old_depot >> 32) + 1) << 32) | next_magazine;
+	}
+	while (!__atomic_compare_exchange_n(&stack->pool_depot, &old_depot, new_depot, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	return first;
+}
+
+// Allocate a new chunk into the magazine:
+int pool_grow(struct Stack* stack, struct NodeMagazine* magazine)
+{
+	unsigned chunk_i = __atomic_load_n(&stack->pool_num_chunks, __ATOMIC_RELAXED);
+	if (chunk_i >= POOL_MAX_CHUNKS)
+	{
+		return -1;
+	}
+
+	struct StackNode* chunk = malloc(POOL_CHUNK_SIZE * sizeof(struct StackNode));
+	if (chunk == NULL)
+	{
+		return -1;
+	}
+
+	// Take the next chunk index, the count never goes past the cap:
+	while (!__atomic_compare_exchange_n(&stack->pool_num_chunks, &chunk_i, chunk_i + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+		if (chunk_i >= POOL_MAX_CHUNKS)
+		{
+			free(chunk);
+			return -1;
+		}
+	}
+
+	for (unsigned node_i = 0; node_i < POOL_CHUNK_SIZE; ++node_i)
+	{
+		chunk[node_i].next       = (node_i + 1 < POOL_CHUNK_SIZE)? &chunk[node_i + 1] : NULL;
+		chunk[node_i].pool_index = chunk_i * POOL_CHUNK_SIZE + node_i;
+	}
+
+	// Nodes reach other threads through the depot, which orders this store before their lookups:
+	__atomic_store_n(&stack->pool_chunks[chunk_i], chunk, __ATOMIC_RELAXED);
+
+	chunk[POOL_CHUNK_SIZE - 1].next = magazine->nodes;
+
+	magazine->nodes      = chunk;
+	magazine->num_nodes += POOL_CHUNK_SIZE;
+
+	return 0;
+}
+
+// A node outside of the pool, pool_free() frees it, NULL if out of memory:
+struct StackNode* pool_alloc_unpooled()
+{
+	struct StackNode* node = malloc(sizeof(struct StackNode));
+	if (node == NULL)
+	{
+		return NULL;
+	}
+
+	node->pool_index = POOL_NO_INDEX;
+
+	return node;
+}
+
+// Take a free node, NULL if out of memory:
+struct StackNode* pool_alloc(struct Stack* stack, struct NodeMagazine* magazine)
+{
+	if (magazine->num_nodes == 0)
+	{
+		// Refill from the depot first, allocate only if it is empty:
+		struct StackNode* nodes = pool_depot_pop(stack);
+
+		if (nodes != NULL)
+		{
+			magazine->nodes     = nodes;
+			magazine->num_nodes = nodes->magazine_size;
+		}
+		else if (pool_grow(stack, magazine) != 0)
+		{
+			// The pool is full:
+			return pool_alloc_unpooled();
+		}
+	}
+
+	struct StackNode* node = magazine->nodes;
+
+	magazine->nodes      = (struct StackNode*) node->next;
+	magazine->num_nodes -= 1;
+
+	return node;
+}
+
+// Give back a node that no thread references anymore:
+void pool_free(struct Stack* stack, struct NodeMagazine* magazine, struct StackNode* node)
+{
+	if (node->pool_index == POOL_NO_INDEX)
+	{
+		free(node);
+		return;
+	}
+
+	node->next = magazine->nodes;
+
+	magazine->nodes      = node;
+	magazine->num_nodes += 1;
+
+	if (magazine->num_nodes < 2 * POOL_MAGAZINE_SIZE)
+	{
+		return;
+	}
+
+	// Keep one magazine, pass the other one to the depot:
+	struct StackNode* last = magazine->nodes;
+	for (unsigned node_i = 1; node_i < POOL_MAGAZINE_SIZE; ++node_i)
+	{
+		last = (struct StackNode*) last->next;
+	}
+
+	struct StackNode* to_depot = magazine->nodes;
+
+	magazine->nodes      = (struct StackNode*) last->next;
+	magazine->num_nodes -= POOL_MAGAZINE_SIZE;
+
+	last->next = NULL;
+
+	pool_depot_push(stack, to_depot, POOL_MAGAZINE_SIZE);
+}
+
+// Return all the nodes of the magazine to the depot, in magazines of at most POOL_MAGAZINE_SIZE nodes:
+void pool_flush(struct Stack* stack, struct NodeMagazine* magazine)
+{
+	struct StackNode* first = magazine->nodes;
+
+	while (first != NULL)
+	{
+		struct StackNode* last      = first;
+		unsigned          num_nodes = 1;
+
+		while (last->next != NULL && num_nodes < POOL_MAGAZINE_SIZE)
+		{
+			last       = (struct StackNode*) last->next;
+			num_nodes += 1;
+		}
+
+		struct StackNode* rest = (struct StackNode*) last->next;
+
+		last->next = NULL;
+
+		pool_depot_push(stack, first, num_nodes);
+
+		first = rest;
+	}
+
+	magazine->nodes     = NULL;
+	magazine->num_nodes = 0;
+}
+
+//-------------------
+// Elimination array 
+//-------------------
+// D. Hendler, N. Shavit, L. Yerushalmi "A Scalable Lock-free Stack Algorithm"
+
+// Offer the node in a random slot, return 1 if a pop has taken it:
+bool elimination_try_push(struct Stack* stack, struct StackNode* node)
+{
+	struct EliminationSlot* slot = &stack->elimination[fast_random_below(ELIMINATION_ARRAY_SIZE)];
+
+	// Release pairs with the taking pop, which reads the data:
+	struct StackNode* empty = NULL;
+	if (!__atomic_compare_exchange_n(&slot->offer, &empty, node, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+	{
+		return 0;
+	}
+
+	for (unsigned spin = 0; spin < ELIMINATION_SPINS; ++spin)
+	{
+		if (__atomic_load_n(&slot->offer, __ATOMIC_RELAXED) == ELIMINATION_TAKEN)
+		{
+			// Only the offering push frees the slot, so a taken offer is never confused with a new one:
+			__atomic_store_n(&slot->offer, NULL, __ATOMIC_RELAXED);
+			return 1;
+		}
+
+		__asm__ volatile("pause");
+	}
+
+	// Withdraw the offer, unless a pop has just taken it:
+	struct StackNode* expected = node;
+	if (__atomic_compare_exchange_n(&slot->offer, &expected, NULL, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+		return 0;
+	}
+
+	__atomic_store_n(&slot->offer, NULL, __ATOMIC_RELAXED);
+	return 1;
+}
+
+// Take an offered node, NULL if there is none:
+struct StackNode* elimination_try_pop(struct Stack* stack)
+{
+	unsigned start = fast_random_below(ELIMINATION_ARRAY_SIZE);
+
+	// Pops don't wait, so they look at every slot:
+	for (unsigned slot_i = 0; slot_i < ELIMINATION_ARRAY_SIZE; ++slot_i)
+	{
+		struct EliminationSlot* slot = &stack->elimination[(start + slot_i) % ELIMINATION_ARRAY_SIZE];
+
+		struct StackNode* offer = __atomic_load_n(&slot->offer, __ATOMIC_RELAXED);
+
+		if (offer != NULL && offer != ELIMINATION_TAKEN &&
+		    __atomic_compare_exchange_n(&slot->offer, &offer, ELIMINATION_TAKEN, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			return offer;
+		}
+	}
+
+	return NULL;
+}
+
 //--------------------
 // Memory reclamation 
 //--------------------
@@ -160,19 +502,22 @@ void add_to_reclaim_list(struct Stack* stack, struct StackNode* node)
 	while (!__atomic_compare_exchange_n(&stack->to_reclaim, &node->next, node, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
 }
 
-void delete_nodes_with_no_hazards(struct Stack* stack)
+void delete_nodes_with_no_hazards(struct Stack* stack, struct NodeMagazine* magazine)
 {
 	// Acquire exclusive access to the reclaim list:
 	struct StackNode* current = (struct StackNode*) __atomic_exchange_n(&stack->to_reclaim, NULL, __ATOMIC_RELAXED);
 
+	// The nodes are unlinked from head, any hazard pointer set on them before that is visible now:
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
 	while (current != NULL)
 	{
 		struct StackNode* next = (struct StackNode*) current->next;
 
 		if (!outstanding_hazard_pointers_for(stack, current))
 		{
-			// Delete non-hazard node:
-			free(current);
+			// Recycle non-hazard node:
+			pool_free(stack, magazine, current);
 		}
 		else
 		{
@@ -196,8 +541,8 @@ int stack_init(struct Stack** stack_ptr, void (*data_destructor)(Data_t*))
 		return -1;
 	}
 
-	// Allocate memory for the stack:
-	*stack_ptr = malloc(sizeof(struct Stack));
+	// Allocate memory for the stack (elimination slots are cache-line-aligned):
+	*stack_ptr = aligned_alloc(CACHE_LINE_SIZE, sizeof(struct Stack));
 	if (*stack_ptr == NULL)
 	{
 		return -1;
@@ -212,19 +557,37 @@ int stack_init(struct Stack** stack_ptr, void (*data_destructor)(Data_t*))
 		return -1;
 	} 
 
-	// Create hazard pointer array:
-	stack->hazard_pointers = calloc(MAX_HAZARD_POINTERS, sizeof(struct HazardPointer));
+	// Create hazard pointer array, a cache line per thread:
+	stack->hazard_pointers = aligned_alloc(CACHE_LINE_SIZE, MAX_HAZARD_POINTERS * sizeof(struct HazardPointer));
 	if (stack->hazard_pointers == NULL)
 	{
 		stack->errno = NO_MEMORY;
 		return -1;
 	}
 
+	memset((struct HazardPointer*) stack->hazard_pointers, 0, MAX_HAZARD_POINTERS * sizeof(struct HazardPointer));
+
+	// Node pool:
+	stack->pool_chunks = calloc(POOL_MAX_CHUNKS, sizeof(struct StackNode*));
+	if (stack->pool_chunks == NULL)
+	{
+		stack->errno = NO_MEMORY;
+		return -1;
+	}
+
+	stack->pool_num_chunks = 0;
+	stack->pool_depot      = 0;
+
 	// Reclamation:
 	stack->to_reclaim = NULL;
 	stack->data_destructor = data_destructor;
 	stack->reclaim_counter = 0;
 
+	for (unsigned slot_i = 0; slot_i < ELIMINATION_ARRAY_SIZE; ++slot_i)
+	{
+		stack->elimination[slot_i].offer = NULL;
+	}
+
 	// Error checking:
 	stack->head  = NULL;
 	stack->errno = NO_ERROR;
@@ -239,34 +602,44 @@ void stack_free(struct Stack* stack)
 
 	// Assumption: calling thread has exclusive access to the stack 
 
-	// Delete stack nodes:
-	struct StackNode* to_delete = (struct StackNode*) stack->head;
-	while (to_delete != NULL)
+	// Destroy the data of stack nodes:
+	if (stack->data_destructor != NULL)
 	{
-		struct StackNode* next = (struct StackNode*) to_delete->next;
-
-		if (stack->data_destructor != NULL)
+		for (struct StackNode* node = (struct StackNode*) stack->head; node != NULL; node = (struct StackNode*) node->next)
 		{
-			stack->data_destructor(&to_delete->data);
+			stack->data_destructor(&node->data);
 		}
-
-		free(to_delete);
-
-		to_delete = next;
 	}
 
-	// Reclaim deleted nodes:
-	to_delete = (struct StackNode*) stack->to_reclaim;
-	while (to_delete != NULL)
+	// Nodes allocated past the pool are only in the stack or on the reclaim list:
+	volatile struct StackNode* lists[2] = {stack->head, stack->to_reclaim};
+
+	for (unsigned list_i = 0; list_i < 2; ++list_i)
 	{
-		struct StackNode* next = (struct StackNode*) to_delete->next;
+		struct StackNode* node = (struct StackNode*) lists[list_i];
 
-		free(to_delete);
+		while (node != NULL)
+		{
+			struct StackNode* next = (struct StackNode*) node->next;
 
-		to_delete = next;
+			if (node->pool_index == POOL_NO_INDEX)
+			{
+				free(node);
+			}
+
+			node = next;
+		}
 	}
 
-	free((struct StackNode*) stack->hazard_pointers);
+	// Every other node (in the stack, on the reclaim list or in the pool) lives in a chunk:
+	for (unsigned chunk_i = 0; chunk_i < stack->pool_num_chunks; ++chunk_i)
+	{
+		free(stack->pool_chunks[chunk_i]);
+	}
+
+	free((struct StackNode**) stack->pool_chunks);
+
+	free((struct HazardPointer*) stack->hazard_pointers);
 
 	// Delete thread-local storage key:
 	pthread_key_delete(stack->thread_local_key);
@@ -289,8 +662,21 @@ int stack_push(struct Stack* stack, Data_t data)
 		return -1;
 	}
 
-	// Allocate node to store in the stack:
-	struct StackNode* new_node = malloc(sizeof(struct StackNode));
+	// Take a node from the thread's magazine:
+	struct HazardPointer* hp = get_hazard_pointer_for_current_thread(stack);
+
+	struct StackNode* new_node;
+
+	if (hp != NULL)
+	{
+		new_node = pool_alloc(stack, &hp->magazine);
+	}
+	else
+	{
+		// Threads without a hazard pointer have no magazine, their nodes live outside of the pool:
+		new_node = pool_alloc_unpooled();
+	}
+
 	if (new_node == NULL)
 	{
 		stack->errno = NO_MEMORY;
@@ -303,7 +689,7 @@ int stack_push(struct Stack* stack, Data_t data)
 	struct StackNode* top;
 
 	unsigned backoff_counter = 0;
-	do
+	while (1)
 	{
 		if (backoff_counter == YIELD_BACKOFF)
 		{
@@ -317,13 +703,19 @@ int stack_push(struct Stack* stack, Data_t data)
 		// Current node is the new head:
 		__atomic_store_n(&new_node->next, top, __ATOMIC_RELAXED);
 
-		backoff_counter += 1;
+		if (__atomic_compare_exchange_n(&stack->head, &top, new_node, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+			return 0;
+		}
 
-	}
-	// Keep spinning until the head is successfully set:
-	while (!__atomic_compare_exchange_n(&stack->head, &top, new_node, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+		// Collided on the head, hand the node to a pop instead:
+		if (elimination_try_push(stack, new_node))
+		{
+			return 0;
+		}
 
-	return 0;
+		backoff_counter += 1;
+	}
 }
 
 //----------------
@@ -346,9 +738,13 @@ int stack_pop(struct Stack* stack, Data_t* place_to_pop)
 
 	// Get hazard pointer:
 	struct HazardPointer* hp = get_hazard_pointer_for_current_thread(stack);
+	if (hp == NULL)
+	{
+		return -1;
+	}
 
 	struct StackNode* old_head;
-	do
+	while (1)
 	{
 		old_head = (struct StackNode*) __atomic_load_n(&stack->head, __ATOMIC_ACQUIRE);
 		struct StackNode* tmp;
@@ -360,12 +756,35 @@ int stack_pop(struct Stack* stack, Data_t* place_to_pop)
 			
 			__atomic_store_n(&hp->pointer, old_head, __ATOMIC_RELAXED);
 
+			// The hazard pointer must be visible before head is read again (store-load order),
+			// otherwise a reclaimer can miss it and recycle the node (pairs with the fence
+			// in delete_nodes_with_no_hazards()):
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
 			old_head = (struct StackNode*) __atomic_load_n(&stack->head, __ATOMIC_RELAXED);
 		}
 		while (old_head != tmp);
+
+		if (old_head == NULL ||
+		    __atomic_compare_exchange_n(&stack->head, &old_head, old_head->next, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+
+		// Collided on the head, take the node of a push instead:
+		struct StackNode* offer = elimination_try_pop(stack);
+		if (offer != NULL)
+		{
+			__atomic_store_n(&hp->pointer, NULL, __ATOMIC_RELAXED);
+
+			*place_to_pop = offer->data;
+
+			// The node has never been in the stack, so no other thread can reference it:
+			pool_free(stack, &hp->magazine, offer);
+
+			return 0;
+		}
 	}
-	while (old_head != NULL &&
-	       !__atomic_compare_exchange_n(&stack->head, &old_head, old_head->next, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
 
 	// Clear the hazard pointer:
 	__atomic_store_n(&hp->pointer, NULL, __ATOMIC_RELAXED);
@@ -390,7 +809,7 @@ int stack_pop(struct Stack* stack, Data_t* place_to_pop)
 	{
 		__atomic_store_n(&stack->reclaim_counter, 0, __ATOMIC_RELAXED);
 
-		delete_nodes_with_no_hazards(stack);
+		delete_nodes_with_no_hazards(stack, &hp->magazine);
 	}
 
 	return 0;
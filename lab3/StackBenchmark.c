@@ -27,6 +27,9 @@ const unsigned EFFICIENCY_TEST_NUM_TO_POP  = 10000;
 const unsigned FAIRNESS_TEST_NUM_TO_PUSH = 1000;
 const unsigned FAIRNESS_TEST_NUM_TO_POP  = 1000;
 
+// Alternation test:
+const unsigned ALTERNATION_TEST_NUM_PAIRS = 10000;
+
 //--------
 // Colors 
 //--------
@@ -48,6 +51,9 @@ struct CommonThreadArgs
 {
 	bool check_correctness;
 
+	// Pop right after every push instead of pushing everything first:
+	bool alternate;
+
 	unsigned num_to_push;
 	unsigned num_to_pop;
 
@@ -83,21 +89,17 @@ void* one_thread_job(void* args)
 		exit(EXIT_FAILURE);
 	}
 
-	// Push-cycle:
-	for (unsigned i = 0; i < common_args->num_to_push; ++i)
-	{
-		unsigned to_push = common_args->num_to_push * thread_args->thread_i + i;
-
-		stack_push(common_args->stack, to_push);
-	}
-
-	// Pop-cycle:
-	if (common_args->check_correctness)
+	if (common_args->alternate)
 	{
+		// Push-pop-cycle:
 		unsigned pop_location;
-		for (unsigned i = 0; i < common_args->num_to_pop; ++i)
+		for (unsigned i = 0; i < common_args->num_to_push; ++i)
 		{
-			if (stack_pop(common_args->stack, &pop_location) == 0)
+			unsigned to_push = common_args->num_to_push * thread_args->thread_i + i;
+
+			stack_push(common_args->stack, to_push);
+
+			if (stack_pop(common_args->stack, &pop_location) == 0 && common_args->check_correctness)
 			{
 				__atomic_add_fetch(&common_args->pop_log_array[pop_location], 1, __ATOMIC_RELAXED);
 			}
@@ -105,10 +107,33 @@ void* one_thread_job(void* args)
 	}
 	else
 	{
-		unsigned pop_location;
-		for (unsigned i = 0; i < common_args->num_to_pop; ++i)
+		// Push-cycle:
+		for (unsigned i = 0; i < common_args->num_to_push; ++i)
 		{
-			stack_pop(common_args->stack, &pop_location);
+			unsigned to_push = common_args->num_to_push * thread_args->thread_i + i;
+
+			stack_push(common_args->stack, to_push);
+		}
+
+		// Pop-cycle:
+		if (common_args->check_correctness)
+		{
+			unsigned pop_location;
+			for (unsigned i = 0; i < common_args->num_to_pop; ++i)
+			{
+				if (stack_pop(common_args->stack, &pop_location) == 0)
+				{
+					__atomic_add_fetch(&common_args->pop_log_array[pop_location], 1, __ATOMIC_RELAXED);
+				}
+			}
+		}
+		else
+		{
+			unsigned pop_location;
+			for (unsigned i = 0; i < common_args->num_to_pop; ++i)
+			{
+				stack_pop(common_args->stack, &pop_location);
+			}
 		}
 	}
 
@@ -127,7 +152,7 @@ void* one_thread_job(void* args)
 	return NULL;
 }
 
-void run_test(bool check_correctness, unsigned num_to_push, unsigned num_to_pop,
+void run_test(bool check_correctness, bool alternate, unsigned num_to_push, unsigned num_to_pop,
               void (*printout_results)(struct CommonThreadArgs*, struct ThreadArgs*, unsigned))
 {
 	// Allocate pop-log array:
@@ -146,6 +171,7 @@ void run_test(bool check_correctness, unsigned num_to_push, unsigned num_to_pop,
 	struct CommonThreadArgs common_args =
 	{
 		.check_correctness = check_correctness,
+		.alternate         = alternate,
 		.num_to_push       = num_to_push,
 		.num_to_pop        = num_to_pop,
 		.pop_log_array     = pop_log_array
@@ -252,7 +278,7 @@ void correctness_test_printout(struct CommonThreadArgs* common_args, struct Thre
 
 void run_test_correctness()
 {
-	run_test(1, CORRECTNESS_TEST_NUM_TO_PUSH, CORRECTNESS_TEST_NUM_TO_PUSH, &correctness_test_printout);
+	run_test(1, 0, CORRECTNESS_TEST_NUM_TO_PUSH, CORRECTNESS_TEST_NUM_TO_PUSH, &correctness_test_printout);
 }
 
 //-----------------------------
@@ -275,17 +301,17 @@ void efficiency_test_printout(struct CommonThreadArgs* common_args, struct Threa
 
 void run_test_efficiency_push()
 {
-	run_test(0, EFFICIENCY_TEST_NUM_TO_PUSH, 0, &efficiency_test_printout);
+	run_test(0, 0, EFFICIENCY_TEST_NUM_TO_PUSH, 0, &efficiency_test_printout);
 }
 
 void run_test_efficiency_pop()
 {
-	run_test(0, 0, EFFICIENCY_TEST_NUM_TO_POP, &efficiency_test_printout);
+	run_test(0, 0, 0, EFFICIENCY_TEST_NUM_TO_POP, &efficiency_test_printout);
 }
 
 void run_test_efficiency_pop_push()
 {
-	run_test(0, EFFICIENCY_TEST_NUM_TO_PUSH, EFFICIENCY_TEST_NUM_TO_POP, &efficiency_test_printout);
+	run_test(0, 0, EFFICIENCY_TEST_NUM_TO_PUSH, EFFICIENCY_TEST_NUM_TO_POP, &efficiency_test_printout);
 }
 
 //---------------------------
@@ -310,15 +336,33 @@ void fairness_test_printout(struct CommonThreadArgs* common_args, struct ThreadA
 
 void run_test_fairness_push()
 {
-	run_test(0, FAIRNESS_TEST_NUM_TO_PUSH, 0, &fairness_test_printout);
+	run_test(0, 0, FAIRNESS_TEST_NUM_TO_PUSH, 0, &fairness_test_printout);
 }
 
 void run_test_fairness_pop()
 {
-	run_test(0, 0, FAIRNESS_TEST_NUM_TO_POP, &fairness_test_printout);
+	run_test(0, 0, 0, FAIRNESS_TEST_NUM_TO_POP, &fairness_test_printout);
 }
 
 void run_test_fairness_pop_push()
 {
-	run_test(0, FAIRNESS_TEST_NUM_TO_PUSH, FAIRNESS_TEST_NUM_TO_POP, &fairness_test_printout);
+	run_test(0, 0, FAIRNESS_TEST_NUM_TO_PUSH, FAIRNESS_TEST_NUM_TO_POP, &fairness_test_printout);
+}
+
+//------------------------------------
+// Benchmark #8: Push-Pop alternation 
+//------------------------------------
+
+void run_test_efficiency_alternate()
+{
+	run_test(0, 1, ALTERNATION_TEST_NUM_PAIRS, ALTERNATION_TEST_NUM_PAIRS, &efficiency_test_printout);
+}
+
+//--------------------------------------------------
+// Benchmark #9: Push-Pop alternation (correctness) 
+//--------------------------------------------------
+
+void run_test_correctness_alternate()
+{
+	run_test(1, 1, ALTERNATION_TEST_NUM_PAIRS, ALTERNATION_TEST_NUM_PAIRS, &correctness_test_printout);
 }
@@ -29,6 +29,18 @@
 // Each thread first pushes N values, then pops N values
 // Maximum time is the result.
 //------------------------------------------------
+// Benchmark #8: Push-Pop alternation Efficiency
+// Each thread pushes a value and pops one right after, N times
+// Pushes and pops collide on the head all the time (elimination)
+// Average time is the result.
+//------------------------------------------------
+// Benchmark #9: Push-Pop alternation Correctness
+// Each thread pushes a value and pops one right after, N times
+// Values are distinct for all threads
+// The test is passed if every value pushed was popped exactly once,
+// whether through the head or through the elimination array,
+// and the stack is empty
+//------------------------------------------------
 
 void run_test_correctness();
 void run_test_efficiency_push();
@@ -37,3 +49,5 @@ void run_test_efficiency_pop_push();
 void run_test_fairness_push();
 void run_test_fairness_pop();
 void run_test_fairness_pop_push();
+void run_test_efficiency_alternate();
+void run_test_correctness_alternate();
@@ -0,0 +1,150 @@
+#include "Stack.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+//--------
+// Colors
+//--------
+
+#define RED      "\033[1;31m"
+#define GREEN    "\033[1;32m"
+#define YELLOW   "\033[1;33m"
+#define BLUE     "\033[1;34m"
+#define MAGENTA  "\033[1;35m"
+#define CYAN     "\033[1;36m"
+#define WHITE    "\033[0;37m"
+#define RESET    "\033[0m"
+
+//------------------------------------------------
+// Stress test
+//------------------------------------------------
+// Every thread does a random mix of pushes and pops on one stack,
+// so pushes, pops, elimination and node recycling all overlap.
+// The test is passed if the sum of the values pushed equals the sum
+// of the values popped, the stack drained at the end included.
+//------------------------------------------------
+
+#define STRESS_TEST_NUM_THREADS 32
+
+const unsigned STRESS_TEST_NUM_OPERATIONS = 300000;
+const unsigned STRESS_TEST_NUM_ROUNDS     = 3;
+
+struct StressArgs
+{
+	struct Stack* stack;
+	unsigned seed;
+
+	// Sums of the values this thread pushed and popped:
+	unsigned long long pushed_sum;
+	unsigned long long popped_sum;
+};
+
+void* stress_thread_job(void* args)
+{
+	struct StressArgs* stress_args = (struct StressArgs*) args;
+
+	unsigned seed = stress_args->seed;
+
+	for (unsigned i = 0; i < STRESS_TEST_NUM_OPERATIONS; ++i)
+	{
+		// Linear congruential generator, good enough to mix the operations:
+		seed = seed * 1103515245 + 12345;
+
+		if ((seed >> 16) & 1)
+		{
+			Data_t to_push = (seed >> 8) & 0xFFFF;
+
+			if (stack_push(stress_args->stack, to_push) == 0)
+			{
+				stress_args->pushed_sum += to_push;
+			}
+		}
+		else
+		{
+			Data_t popped;
+
+			if (stack_pop(stress_args->stack, &popped) == 0)
+			{
+				stress_args->popped_sum += popped;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+//------
+// Main
+//------
+
+int main()
+{
+	printf(CYAN "Random PUSH-POP stress test (%u threads):\n" RESET, STRESS_TEST_NUM_THREADS);
+
+	struct StressArgs stress_args[STRESS_TEST_NUM_THREADS];
+	pthread_t         threads    [STRESS_TEST_NUM_THREADS];
+
+	int all_passed = 1;
+
+	for (unsigned round = 0; round < STRESS_TEST_NUM_ROUNDS; ++round)
+	{
+		struct Stack* stack;
+		if (stack_init(&stack, NULL) != 0)
+		{
+			fprintf(stderr, MAGENTA "[Error] Unable to init the stack\n" RESET);
+			exit(EXIT_FAILURE);
+		}
+
+		for (unsigned thread_i = 0; thread_i < STRESS_TEST_NUM_THREADS; ++thread_i)
+		{
+			stress_args[thread_i].stack      = stack;
+			stress_args[thread_i].seed       = round * STRESS_TEST_NUM_THREADS + thread_i;
+			stress_args[thread_i].pushed_sum = 0;
+			stress_args[thread_i].popped_sum = 0;
+
+			if (pthread_create(&threads[thread_i], NULL, stress_thread_job, &stress_args[thread_i]) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to create thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		unsigned long long pushed_sum = 0;
+		unsigned long long popped_sum = 0;
+
+		for (unsigned thread_i = 0; thread_i < STRESS_TEST_NUM_THREADS; ++thread_i)
+		{
+			if (pthread_join(threads[thread_i], NULL) != 0)
+			{
+				fprintf(stderr, MAGENTA "[Error] Unable to join thread\n" RESET);
+				exit(EXIT_FAILURE);
+			}
+
+			pushed_sum += stress_args[thread_i].pushed_sum;
+			popped_sum += stress_args[thread_i].popped_sum;
+		}
+
+		// Drain the values left in the stack:
+		Data_t popped;
+		while (stack_pop(stack, &popped) == 0)
+		{
+			popped_sum += popped;
+		}
+
+		if (pushed_sum == popped_sum)
+		{
+			printf(YELLOW "Round %u: pushed %llu, popped %llu " GREEN "PASSED\n" RESET, round, pushed_sum, popped_sum);
+		}
+		else
+		{
+			printf(YELLOW "Round %u: pushed %llu, popped %llu " RED "FAILED\n" RESET, round, pushed_sum, popped_sum);
+			all_passed = 0;
+		}
+
+		stack_free(stack);
+	}
+
+	return all_passed? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -64,6 +64,14 @@ int main()
 
 	printf(CYAN "PUSH-POP fairness test:\n" RESET);
 	run_test_fairness_pop_push();
+
+	// Elimination tests:
+
+	printf(CYAN "PUSH-POP alternation efficiency test:\n" RESET);
+	run_test_efficiency_alternate();
+
+	printf(CYAN "PUSH-POP alternation correctness test:\n" RESET);
+	run_test_correctness_alternate();
 	
 	return EXIT_SUCCESS;
 }
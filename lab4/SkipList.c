@@ -1,4 +1,5 @@
 #include "SkipList.h"
+#include "FastRandom.h"
 
 #include <limits.h>
 #include <pthread.h>
@@ -164,12 +165,13 @@ unsigned generate_level()
 {
 	unsigned generated = 0;
 
-	int rand = random();
-	while (generated < NUM_LEVELS - 1 && rand < RAND_MAX/2)
+	// Every random bit is a coin flip, random() would serialize the inserting threads:
+	uint64_t coins = fast_random();
+	while (generated < NUM_LEVELS - 1 && (coins & 0x01))
 	{
 		generated += 1;
 
-		rand = random();
+		coins >>= 1;
 	}
 
 	return generated;